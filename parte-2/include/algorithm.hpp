@@ -1,34 +1,102 @@
 #pragma once
 #include "graph_utils.hpp"
 #include "open_list.hpp"
+#include <chrono>
 #include <limits>
 #include <vector>
 
+struct AlternativeRoute {
+  std::vector<int> path;
+  double cost;
+};
+
 struct AlgorithmResult {
   std::vector<int> path;
   double cost;
   std::size_t expansions;
   long long ms;
+  // Proven suboptimality bound: cost <= bound * optimal (1.0 = optimal)
+  double bound = 1.0;
+  // Alternative routes ranked by cost (only filled by run_alternatives)
+  std::vector<AlternativeRoute> alternatives = {};
+  // CSR arc of every step: arcs[i] goes from path[i] to path[i + 1]
+  std::vector<int> arcs = {};
+  // Winning source / target of run_multi (-1 otherwise)
+  int source = -1;
+  int target = -1;
 };
 
 class Algorithm {
 public:
   static constexpr double INF = std::numeric_limits<double>::max();
 
-  Algorithm(Graph &g, int start, int goal)
+  // Large constant for initialization (integer costs)
+  static constexpr int INF_INT = 2000000000;
+
+  Algorithm(const Graph &g, int start, int goal)
       : graph_(g), start_(start), goal_(goal), open_(), closed_(g.n, 0),
-        g_(g.n, INF), parent_(g.n, -1) {}
+        g_(g.n, INF), parent_(g.n, -1), parent_arc_(g.n, -1) {}
+
+  // Reuses the workspace (allocated arrays) for another query
+  void set_query(int start, int goal) {
+    start_ = start;
+    goal_ = goal;
+  }
 
   // Heuristic
   [[nodiscard]] int h(int n, double cos_lat_goal);
 
+  // Heuristic estimate of u when v is the goal. An arc u -> v lighter than
+  // this makes h overestimate, and A* (and the route cache) return
+  // non-optimal routes.
+  [[nodiscard]] static int min_arc_weight(const Graph &g, int u, int v);
+
   // Main method
   [[nodiscard]] AlgorithmResult run();
 
   // Dijkstra for comparison
   [[nodiscard]] AlgorithmResult run_dijkstra();
 
+  // Weighted A* (f = g + w·h): cost <= w · optimal
+  [[nodiscard]] AlgorithmResult run_weighted(double w);
+
+  // Anytime weighted A*: first solution with weight w, then lowers w towards
+  // 1 improving the solution until deadline_ms expires
+  [[nodiscard]] AlgorithmResult run_anytime(double w, long long deadline_ms);
+
+  // Optimal path plus up to k via-node alternatives derived from one
+  // bidirectional Dijkstra. `reverse` must be graph.transposed().
+  [[nodiscard]] AlgorithmResult run_alternatives(const Graph &reverse, int k);
+
+  // Closest (source, target) pair: one search seeded with every source
+  // (at its offset, if given). Target offsets, if given, are added to the
+  // cost of reaching each target (e.g. the rest of a contracted chain).
+  [[nodiscard]] AlgorithmResult
+  run_multi(const std::vector<int> &sources, const std::vector<int> &offsets,
+            const std::vector<int> &targets,
+            const std::vector<int> &target_offsets = {});
+
+  // Hash-distributed parallel A* (HDA*) on `threads` workers; returns the
+  // same optimal cost as run(). Defined in parallel-astar.cpp.
+  [[nodiscard]] AlgorithmResult run_parallel(unsigned threads);
+
 private:
+  using Clock = std::chrono::high_resolution_clock;
+
+  // One weighted A* pass pruning nodes that cannot beat `incumbent`.
+  // Returns the cost found (or `incumbent` if none is better) and leaves
+  // parent_ describing the path when it improves.
+  int weighted_search(double w, int incumbent, Clock::time_point deadline,
+                      std::size_t &expansions, bool &timed_out);
+
+  void reconstruct_path(int target, std::vector<int> &path,
+                        std::vector<int> &arcs) const;
+
+  // Alternative routes helpers
+  bool locally_optimal(int x, int y, double length, std::size_t &expansions);
+  double shared_length(const std::vector<int> &p, const std::vector<double> &d,
+                       const std::vector<int> &q);
+
   // Graph components
   Graph const &graph_;
   int start_;
@@ -36,9 +104,27 @@ private:
 
   // List components
   OpenList open_;
-  std::vector<char> closed_;
+  HugeVector<char> closed_;
+
+  // SOA for g(n), parent(n) and the arc used to reach n
+  HugeVector<double> g_;
+  HugeVector<int> parent_;
+  HugeVector<int> parent_arc_;
+
+  // Backward search and scratch state for alternative routes (allocated on
+  // first use)
+  OpenList open_back_;
+  HugeVector<char> closed_back_;
+  HugeVector<double> g_back_;
+  HugeVector<int> parent_back_; // next node towards the goal
+  std::vector<int> settled_;    // nodes settled by the forward search
+  HugeVector<int> via_next_;    // next node on a reference path (-1: none)
+  HugeVector<double> local_g_;
+
+  // Offset of every target of run_multi, -1 for the rest (allocated on
+  // first use)
+  std::vector<int> target_offset_;
 
-  // SOA for g(n) and parent(n)
-  std::vector<double> g_;
-  std::vector<int> parent_;
+  // One OpenList per run_parallel worker (allocated on first use)
+  std::vector<OpenList> parallel_open_;
 };
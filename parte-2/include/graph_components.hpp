@@ -0,0 +1,30 @@
+#pragma once
+#include "graph_utils.hpp"
+#include <string>
+#include <vector>
+
+namespace GraphComponents {
+
+// Computes Graph::component (iterative Tarjan) and Graph::component_group.
+// Returns the number of strongly connected components.
+int compute(Graph &g);
+
+// Index persistence next to the map (<mapa>.scc). load() returns false if
+// the file is missing or was built for a different graph.
+bool load(Graph &g, const std::string &filename);
+bool save(const Graph &g, const std::string &filename);
+
+// Loads the index from filename, computing and saving it if needed
+void load_or_compute(Graph &g, const std::string &filename);
+
+// Component with the most nodes (requires the index)
+int largest(const Graph &g);
+
+// Builds a compact graph with only the nodes of component `comp`.
+// original_ids[i] is the id in g of node i of the new graph.
+Graph extract(const Graph &g, int comp, std::vector<int> &original_ids);
+
+// Writes g as DIMACS files <dataset_name>.gr / .co
+bool write_dimacs(const Graph &g, const std::string &dataset_name);
+
+} // namespace GraphComponents
@@ -0,0 +1,61 @@
+#pragma once
+#include "algorithm.hpp"
+#include "graph_utils.hpp"
+#include <vector>
+
+/***
+ * Degree-2 chain contraction.
+ *
+ * A node whose only neighbours (in either direction) are two distinct
+ * nodes a and b, joined as a one-way (a -> v -> b) or two-way road, just
+ * models road geometry: every shortest path through it goes a -> v -> b
+ * or b -> v -> a. Maximal chains of such nodes are collapsed into single
+ * arcs between the remaining (core) nodes:
+ *
+ *    - core():   compact Graph with the core nodes, one arc per chain
+ *                (weight = sum of the chain) plus the original arcs
+ *                between core nodes. Component ids are inherited.
+ *    - arcs_ptr_ / arcs_: original CSR arcs of every core arc, in order
+ *                (the expansion table).
+ *
+ * route() answers queries whose endpoints may lie inside a chain and
+ * returns the path in original ids and arcs.
+ */
+class ContractedGraph {
+public:
+  explicit ContractedGraph(const Graph &g);
+
+  [[nodiscard]] const Graph &core() const { return core_; }
+
+  // Core id of an original node (-1 if it was contracted)
+  [[nodiscard]] int core_id(int v) const { return core_id_[v]; }
+
+  // Shortest s -> t route (original ids). `solver` must be built on core().
+  [[nodiscard]] AlgorithmResult route(Algorithm &solver, int s, int t) const;
+
+private:
+  struct Slot {
+    int arc; // core arc whose chain contains the node (-1: none)
+    int pos; // the node is the head of original arc `pos` of the chain
+  };
+
+  // Sum of the weights of the first k original arcs of core arc e
+  int prefix(int e, int k) const;
+
+  // Appends the heads of original arcs [from, to) of core arc e
+  void expand(int e, int from, int to, std::vector<int> &path,
+              std::vector<int> &arcs) const;
+
+  const Graph &g_;
+  Graph core_;
+
+  std::vector<int> core_id_;     // original -> core (-1 inside a chain)
+  std::vector<int> original_id_; // core -> original
+  std::vector<int> tail_;        // core arc -> core source node
+
+  std::vector<int> arcs_ptr_; // core arc e -> [arcs_ptr_[e], arcs_ptr_[e+1])
+  std::vector<int> arcs_;     // original arcs of every chain
+
+  // Chains through each contracted node (one per direction)
+  std::vector<Slot> slots_; // 2 per original node
+};
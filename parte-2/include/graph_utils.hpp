@@ -1,4 +1,6 @@
 #pragma once
+#include "huge_page_allocator.hpp"
+#include <cstdint>
 #include <vector>
 
 struct Coord {
@@ -13,13 +15,24 @@ public:
 
   /* row_ptr[u] -> where neighbors of u start
      row_ptr[u+1] -> where neighbors of u end */
-  std::vector<int> row_ptr;
+  HugeVector<int> row_ptr;
 
   /* storage for the neighbors of each node */
-  std::vector<int> col_idx;
+  HugeVector<int> col_idx;
 
-  std::vector<int> weights;
-  std::vector<Coord> coords;
+  HugeVector<int> weights;
+  HugeVector<Coord> coords;
+
+  /* bumped whenever weights change (invalidates cached routes) */
+  std::uint64_t version = 0;
+
+  /* strongly connected component of each node (empty until computed).
+     Ids follow Tarjan's order: an arc between components always goes
+     from a higher id to a lower one. */
+  std::vector<int> component;
+
+  /* weakly connected group of each component (indexed by component id) */
+  std::vector<int> component_group;
 
   Graph() : n(0), m(0) {}
   Graph(int nodes, int edges) : n(nodes), m(edges) {
@@ -38,4 +51,42 @@ public:
   inline std::pair<const int *, const int *> neighbours(int u) const {
     return {col_idx.data() + row_ptr[u], col_idx.data() + row_ptr[u + 1]};
   }
+
+  /***
+   * Graph with every arc reversed (same nodes and coordinates), used by
+   * backward searches.
+   */
+  Graph transposed() const {
+    Graph r(n, m);
+    r.coords = coords;
+    for (int e = 0; e < m; e++)
+      r.row_ptr[col_idx[e] + 1]++;
+    for (int u = 0; u < n; u++)
+      r.row_ptr[u + 1] += r.row_ptr[u];
+
+    std::vector<int> temp_ptr(r.row_ptr.begin(), r.row_ptr.end() - 1);
+    for (int u = 0; u < n; u++) {
+      for (int e = row_ptr[u]; e < row_ptr[u + 1]; e++) {
+        int pos = temp_ptr[col_idx[e]]++;
+        r.col_idx[pos] = u;
+        r.weights[pos] = weights[e];
+      }
+    }
+    return r;
+  }
+
+  /***
+   * O(1) reachability filter using the component index:
+   *    - false: v is certainly unreachable from u
+   *    - true: v may be reachable (always true without the index)
+   */
+  inline bool maybe_reachable(int u, int v) const {
+    if (component.empty())
+      return true;
+    int cu = component[u];
+    int cv = component[v];
+    if (cu == cv)
+      return true;
+    return cu > cv && component_group[cu] == component_group[cv];
+  }
 };
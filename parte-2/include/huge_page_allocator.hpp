@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <sys/mman.h>
+#include <vector>
+
+enum class HugePageMode {
+  OFF,         // regular 4 KiB pages
+  TRANSPARENT, // madvise(MADV_HUGEPAGE): transparent huge pages
+  EXPLICIT     // MAP_HUGETLB (reserved pool), falls back to transparent
+};
+
+namespace HugePages {
+
+constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// Allocations below this size stay on the regular heap
+constexpr std::size_t MIN_BYTES = HUGE_PAGE_SIZE / 2;
+
+// Policy for the following allocations (set before loading the graph)
+inline std::atomic<HugePageMode> &mode() {
+  static std::atomic<HugePageMode> current{HugePageMode::TRANSPARENT};
+  return current;
+}
+
+inline std::size_t round_up(std::size_t bytes) {
+  return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+}
+
+inline void *allocate(std::size_t bytes) {
+  if (bytes < MIN_BYTES)
+    return ::operator new(bytes);
+
+  // Large blocks always come from mmap (whatever the mode) so that
+  // deallocate() does not depend on the mode at allocation time
+  std::size_t size = round_up(bytes);
+  HugePageMode m = mode().load(std::memory_order_relaxed);
+  void *p = MAP_FAILED;
+
+  if (m == HugePageMode::EXPLICIT)
+    p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+  if (p == MAP_FAILED) {
+    p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+      throw std::bad_alloc();
+    madvise(p, size, m == HugePageMode::OFF ? MADV_NOHUGEPAGE : MADV_HUGEPAGE);
+  }
+  return p;
+}
+
+inline void deallocate(void *p, std::size_t bytes) {
+  if (bytes < MIN_BYTES)
+    ::operator delete(p);
+  else
+    munmap(p, round_up(bytes));
+}
+
+} // namespace HugePages
+
+/***
+ * Allocator for the large arrays of the graph and the search workspaces.
+ * Big blocks are mapped on huge pages so that random accesses over a
+ * multi-gigabyte graph do not miss the TLB on every node.
+ */
+template <typename T> struct HugePageAllocator {
+  using value_type = T;
+
+  HugePageAllocator() noexcept = default;
+  template <typename U>
+  HugePageAllocator(const HugePageAllocator<U> &) noexcept {}
+
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(HugePages::allocate(n * sizeof(T)));
+  }
+  void deallocate(T *p, std::size_t n) noexcept {
+    HugePages::deallocate(p, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const HugePageAllocator<U> &) const noexcept {
+    return true;
+  }
+};
+
+template <typename T> using HugeVector = std::vector<T, HugePageAllocator<T>>;
@@ -1,6 +1,7 @@
 #ifndef LOGGER_HPP
 #define LOGGER_HPP
 
+#include <atomic>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
@@ -49,6 +50,14 @@ inline std::string fmt_speed(size_t expansions, long long ms) {
 
 // --- LOGGING FUNCTIONS ---
 
+// Silences the progress messages on stdout (info, graph loading) when the
+// code runs inside another process (shared library). Errors still go to
+// stderr.
+inline std::atomic<bool> &quiet() {
+  static std::atomic<bool> current{false};
+  return current;
+}
+
 inline void print_header() {
   std::cout << "\n"
             << BOLD
@@ -62,15 +71,21 @@ inline void print_header() {
 }
 
 inline void info(const std::string &msg) {
+  if (quiet())
+    return;
   std::cout << "[" << BLUE << "INFO" << RESET << "]  " << msg << std::endl;
 }
 
 inline void print_load_graph(std::string const &filename) {
+  if (quiet())
+    return;
   std::cout << "[" << BLUE << "INFO" << RESET
             << "]  Cargando grafo: " << filename << "...\n";
 }
 // Prints graph loading statistics
 inline void print_graph_stats(long long ms, int nodes, int edges) {
+  if (quiet())
+    return;
 
   std::cout << "[" << GREEN << " OK " << RESET << "]  Grafo cargado en " << BOLD
             << (ms / 1000.0) << "s" << RESET << "\n";
@@ -99,6 +114,27 @@ inline void print_alg_stats(const std::string &alg_name, long long ms,
             << "Coste:       " << fmt_int((long long)cost) << RESET << "\n";
 }
 
+// Suboptimality bound of a weighted / anytime search
+inline void print_bound(double bound) {
+  std::cout << "        -> Cota:        " << std::fixed << std::setprecision(3)
+            << bound << std::defaultfloat << " x óptimo\n";
+}
+
+// Alternative route cost and its stretch over the optimal one
+inline void print_alternative(double cost, double optimal) {
+  std::cout << "        -> Alternativa: " << fmt_int((long long)cost) << " (+"
+            << std::fixed << std::setprecision(1)
+            << (100.0 * (cost - optimal) / optimal) << std::defaultfloat
+            << "%)\n";
+}
+
+// Data TLB misses of the searches (-1: counter not available)
+inline void print_tlb(long long misses) {
+  std::cout << "\n        -> Fallos TLB:  "
+            << (misses < 0 ? std::string("no disponible") : fmt_int(misses))
+            << "\n";
+}
+
 // Final comparison (if both are run)
 inline void print_comparison(double cost_astar, double cost_dijkstra) {
   std::cout
@@ -0,0 +1,24 @@
+#pragma once
+#include "graph_utils.hpp"
+#include <memory>
+#include <vector>
+
+namespace Numa {
+
+struct Node {
+  int id;
+  std::vector<int> cpus;
+};
+
+// NUMA nodes with their CPUs (from sysfs). Without NUMA information a
+// single node with every CPU is returned.
+std::vector<Node> detect();
+
+// Restricts the calling thread to `cpus`
+bool pin_current_thread(const std::vector<int> &cpus);
+
+// Copies g from a thread pinned to `node`: first touch places the pages of
+// the replica in the node's local memory
+std::unique_ptr<Graph> replicate(const Graph &g, const Node &node);
+
+} // namespace Numa
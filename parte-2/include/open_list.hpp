@@ -1,7 +1,10 @@
 #ifndef OPEN_LIST_H
 #define OPEN_LIST_H
 
+#include "node.hpp"
 #include <cassert>
+#include <functional>
+#include <queue>
 #include <vector>
 
 class OpenList {
@@ -10,22 +13,34 @@ private:
   // Usamos int para los IDs de los nodos para ser cache-friendly.
   std::vector<std::vector<int>> buckets_;
 
+  // Desbordamiento: nodos cuyo f cae fuera de la ventana [base_, base_ +
+  // width_). Con heurística consistente casi nunca se usa, pero con A*
+  // ponderado (f = g + w·h) f deja de ser monótono y el rango de la lista
+  // abierta puede superar el tamaño del buffer circular.
+  std::priority_queue<Node, std::vector<Node>, std::greater<Node>> far_;
+
+  int base_;      // Inicio de la ventana cubierta por los buckets
   int current_f_; // El cursor que rastrea el mínimo f actual
-  int count_;     // Número total de elementos en la openlist
+  int count_;     // Número de elementos en los buckets
   int width_;     // Tamaño del buffer circular
 
 public:
   // Constructor: width debe ser mayor que el peso máximo de una arista * C
   explicit OpenList(int width = 100000)
-      : buckets_(width), current_f_(0), count_(0), width_(width) {}
+      : buckets_(width), base_(0), current_f_(0), count_(0), width_(width) {}
 
   inline void push(int u, int f) {
-    // Manejo del cursor para retroceso (re-inserción con mejor coste)
-    // Aunque con heurística consistente, f nunca debería disminuir por debajo
-    // del actual procesado
-    if (count_ > 0 && f < current_f_) {
+    if (count_ == 0) {
+      // Ventana vacía: se recoloca empezando en f
+      base_ = f;
       current_f_ = f;
-    } else if (count_ == 0) {
+    } else if (f < base_ || f >= base_ + width_) {
+      // Fuera de la ventana: compartir bucket con otro f sería incorrecto
+      far_.push(Node(u, f));
+      return;
+    } else if (f < current_f_) {
+      // Retroceso del cursor (re-inserción con mejor coste o heurística
+      // inconsistente, como en A* ponderado)
       current_f_ = f;
     }
 
@@ -34,14 +49,24 @@ public:
   }
 
   inline int pop() {
-    if (count_ == 0)
-      return -1;
+    if (count_ == 0) {
+      if (far_.empty())
+        return -1;
+      refill();
+    }
 
     // Avanzar el cursor hasta encontrar un bucket no vacío
     while (buckets_[current_f_ % width_].empty()) {
       current_f_++;
     }
 
+    // Un nodo desbordado puede tener menor f que el cursor
+    if (!far_.empty() && far_.top().f < current_f_) {
+      int u = far_.top().id;
+      far_.pop();
+      return u;
+    }
+
     int u = buckets_[current_f_ % width_].back();
     buckets_[current_f_ % width_].pop_back();
     count_--;
@@ -56,11 +81,27 @@ public:
     for (auto &bucket : buckets_) {
       bucket.clear();
     }
+    far_ = {};
     count_ = 0;
+    base_ = 0;
     current_f_ = 0;
   }
 
-  inline bool empty() const { return count_ == 0; }
+  inline bool empty() const { return count_ == 0 && far_.empty(); }
+
+private:
+  // Recoloca la ventana en el mínimo desbordado y vuelca a los buckets todos
+  // los nodos desbordados que caben en ella.
+  inline void refill() {
+    base_ = static_cast<int>(far_.top().f);
+    current_f_ = base_;
+    while (!far_.empty() && far_.top().f < base_ + width_) {
+      int f = static_cast<int>(far_.top().f);
+      buckets_[f % width_].push_back(far_.top().id);
+      far_.pop();
+      count_++;
+    }
+  }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+#include "graph_utils.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/***
+ * Buffered route serialization without iostreams.
+ *
+ *    - TEXT:   "1 - (w) - 2 - (w) - 3\n" (1-based ids, one route per line)
+ *    - BINARY: per route, magic "PFB1", uint32 node count, uint32 node ids
+ *              (1-based) and int32 arc weights, in native byte order.
+ *
+ * Routes are formatted into one reusable buffer that is written to the
+ * file only when full, so long routes and batches cost one write per
+ * buffer instead of one stream operation per token.
+ */
+class PathWriter {
+public:
+  enum class Format { TEXT, BINARY };
+
+  explicit PathWriter(Format format = Format::TEXT,
+                      std::size_t capacity = 1 << 20);
+  ~PathWriter();
+
+  PathWriter(const PathWriter &) = delete;
+  PathWriter &operator=(const PathWriter &) = delete;
+
+  bool open(const std::string &filename);
+
+  // arcs[i] is the CSR arc path[i] -> path[i + 1]. Without arcs (e.g.
+  // alternative routes) the cheapest arc is looked up in the graph.
+  void write(const Graph &g, const std::vector<int> &path,
+             const std::vector<int> &arcs = {});
+
+  // Flushes and closes; false if any write failed
+  bool close();
+
+private:
+  void flush();
+
+  // Ensures room for n more bytes
+  void reserve(std::size_t n) {
+    if (size_ + n > buffer_.size())
+      flush();
+  }
+
+  void put(char c) { buffer_[size_++] = c; }
+  void put(const char *s, std::size_t n);
+  void put_uint(unsigned x);
+  void put_raw(const void *data, std::size_t n) {
+    put(static_cast<const char *>(data), n);
+  }
+
+  Format format_;
+  std::vector<char> buffer_;
+  std::size_t size_ = 0;
+  std::FILE *out_ = nullptr;
+  bool ok_ = true;
+};
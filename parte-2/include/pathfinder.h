@@ -0,0 +1,107 @@
+#ifndef PATHFINDER_H
+#define PATHFINDER_H
+
+/*
+ * Stable C API of libpathfinder (for ctypes / other languages).
+ *
+ * Node ids are 0-based. Handles are opaque: a graph is read-only once
+ * loaded and can be shared between threads; a workspace holds the search
+ * arrays of one query at a time and must not be shared.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__GNUC__)
+#define PF_API __attribute__((visibility("default")))
+#else
+#define PF_API
+#endif
+
+typedef struct pf_graph pf_graph;
+typedef struct pf_workspace pf_workspace;
+
+typedef struct pf_cache_stats {
+  unsigned long long hits;         /* exact (start, goal) hits */
+  unsigned long long subpath_hits; /* answered from a cached route */
+  unsigned long long misses;
+  unsigned long long entries;
+  unsigned long long bytes;
+  unsigned long long capacity;
+} pf_cache_stats;
+
+/*
+ * Loads <dataset_name>.gr / .co. Returns NULL on failure. Nothing is written
+ * to stdout; errors are reported on stderr.
+ */
+PF_API pf_graph *pf_graph_load(const char *dataset_name);
+PF_API void pf_graph_free(pf_graph *graph);
+PF_API int pf_graph_nodes(const pf_graph *graph);
+
+PF_API pf_workspace *pf_workspace_create(const pf_graph *graph);
+PF_API void pf_workspace_free(pf_workspace *ws);
+
+/*
+ * Optimal route start -> goal (A*). Writes at most path_capacity node ids to
+ * path and the cost to *cost (-1 if unreachable).
+ * Returns the number of nodes of the route (which may exceed path_capacity;
+ * retry with a larger buffer), 0 if there is no route, -1 on invalid ids.
+ */
+PF_API int pf_query(pf_workspace *ws, int start, int goal, int *path,
+                    int path_capacity, long long *cost);
+
+/*
+ * costs[i] = cost of starts[i] -> goals[i] (-1 if unreachable or invalid),
+ * split across `threads` workers (0 = all cores). Returns 0, or -1 on
+ * invalid arguments.
+ */
+PF_API int pf_batch_query(const pf_graph *graph, const int *starts,
+                          const int *goals, long long *costs, int count,
+                          int threads);
+
+/*
+ * out[i] = node closest to (lats[i], lons[i]) (degrees), split across
+ * `threads` workers (0 = all cores). The spatial index is built on the
+ * first snapping call. Returns 0, or -1 on invalid arguments.
+ */
+PF_API int pf_snap_batch(const pf_graph *graph, const double *lats,
+                         const double *lons, int *out, int count,
+                         int threads);
+
+/*
+ * Writes to out the (at most k) nodes closest to (lat, lon), nearest first.
+ * Returns how many were written, -1 on invalid arguments.
+ */
+PF_API int pf_nearest_k(const pf_graph *graph, double lat, double lon,
+                        int *out, int k);
+
+/*
+ * Enables a route cache of at most max_bytes shared by every query on the
+ * graph (0 disables it). Not thread-safe with running queries.
+ */
+PF_API int pf_cache_enable(pf_graph *graph, unsigned long long max_bytes);
+PF_API int pf_cache_stats_get(const pf_graph *graph, pf_cache_stats *out);
+
+/*
+ * Replicates the graph on every NUMA node. pf_batch_query then pins each
+ * worker to a node and searches that node's local replica. On non-NUMA
+ * machines nothing is copied. Returns the number of NUMA nodes used (1 on
+ * non-NUMA machines). Not thread-safe with running queries.
+ */
+PF_API int pf_numa_enable(pf_graph *graph);
+
+/*
+ * Sets the weight of every arc u -> v and invalidates cached routes.
+ * The weight must not be negative nor below the straight-line distance
+ * u -> v as estimated by the A* heuristic (routes, and the cache, are only
+ * optimal while it holds). Returns the number of arcs updated, -1 on
+ * invalid ids or weight. Not thread-safe with running queries.
+ */
+PF_API int pf_graph_set_weight(pf_graph *graph, int u, int v, int weight);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
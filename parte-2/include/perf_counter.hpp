@@ -0,0 +1,59 @@
+#pragma once
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/***
+ * Data TLB load misses of the calling thread (user space only), read
+ * through perf_event_open. available() is false when the kernel or the
+ * machine (e.g. most VMs) does not expose the counter.
+ */
+class TlbMissCounter {
+public:
+  TlbMissCounter() {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  ~TlbMissCounter() {
+    if (fd_ != -1)
+      close(fd_);
+  }
+
+  TlbMissCounter(const TlbMissCounter &) = delete;
+  TlbMissCounter &operator=(const TlbMissCounter &) = delete;
+
+  bool available() const { return fd_ != -1; }
+
+  void start() {
+    if (fd_ == -1)
+      return;
+    ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+  }
+
+  // Misses since start(), -1 if unavailable
+  long long stop() {
+    if (fd_ == -1)
+      return -1;
+    ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+    long long count = 0;
+    if (read(fd_, &count, sizeof(count)) != sizeof(count))
+      return -1;
+    return count;
+  }
+
+private:
+  int fd_;
+};
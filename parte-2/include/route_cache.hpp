@@ -0,0 +1,121 @@
+#pragma once
+#include "graph_utils.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+/***
+ * Memory-bounded cache of optimal routes shared by all query threads.
+ *
+ *    - Exact hits: (start, goal) already cached.
+ *    - Subpath hits: start and goal appear, in this order, on a cached
+ *      route; any subpath of a shortest path is a shortest path.
+ *
+ * Lookups only take a shared lock. Eviction follows CLOCK (approximate
+ * LRU) and admission follows TinyLFU: when the cache is full a new route
+ * only replaces the victim if it has been requested at least as often.
+ * Entries belong to one weights version (Graph::version): inserting a
+ * route of a newer version drops every older entry.
+ *
+ * The byte budget covers the routes, their hash table entries and the
+ * per-node occurrence index (one int per graph node, allocated on the
+ * first insert).
+ */
+class RouteCache {
+public:
+  struct Stats {
+    std::uint64_t hits;
+    std::uint64_t subpath_hits;
+    std::uint64_t misses;
+    std::uint64_t entries;
+    std::uint64_t bytes;
+    std::uint64_t capacity;
+  };
+
+  explicit RouteCache(std::size_t max_bytes);
+
+  // Fills path and cost and returns true on a hit
+  bool lookup(int start, int goal, std::uint64_t version,
+              std::vector<int> &path, long long &cost);
+
+  // Caches a route found on g (path from start to goal)
+  void insert(const Graph &g, const std::vector<int> &path);
+
+  // Drops every entry (e.g. weights changed)
+  void clear();
+
+  Stats stats() const;
+
+private:
+  struct Entry {
+    int start;
+    int goal;
+    std::vector<int> nodes;
+    std::vector<long long> prefix; // cost from start to nodes[i]
+    std::vector<int> occurrences;  // pool index of nodes[i]
+    std::size_t bytes;
+    std::atomic<bool> referenced{false};
+  };
+
+  // Position of a node on a cached route. The occurrences of each node
+  // form a doubly linked list (head_[node]) inside one pooled array.
+  struct Occurrence {
+    int slot;
+    int pos;
+    int prev;
+    int next;
+  };
+
+  static std::uint64_t key(int start, int goal) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(start))
+            << 32) |
+           static_cast<std::uint32_t>(goal);
+  }
+
+  // Count-min sketch of request frequencies (TinyLFU)
+  void record(std::uint64_t k);
+  int frequency(std::uint64_t k) const;
+
+  int pick_victim();
+  void evict(int slot);
+  void clear_locked();
+  int link(int node, int slot, int pos);
+  void unlink(int node, int index);
+
+  mutable std::shared_mutex mutex_;
+  std::size_t max_bytes_;
+  std::size_t bytes_ = 0;
+  std::uint64_t version_ = 0;
+
+  std::vector<std::unique_ptr<Entry>> slots_;
+  std::vector<int> free_slots_;
+  std::size_t hand_ = 0; // CLOCK hand
+  std::unordered_map<std::uint64_t, int> exact_;
+  std::vector<int> head_; // node -> first occurrence (-1: none)
+  // Occurrence pool in fixed blocks: growing it never copies or leaves a
+  // freed array behind
+  static constexpr int POOL_BLOCK_BITS = 12;
+  std::vector<std::unique_ptr<Occurrence[]>> pool_;
+  int pool_size_ = 0;
+  int free_occurrence_ = -1; // free list through Occurrence::next
+
+  Occurrence &occurrence(int i) {
+    return pool_[i >> POOL_BLOCK_BITS][i & ((1 << POOL_BLOCK_BITS) - 1)];
+  }
+  const Occurrence &occurrence(int i) const {
+    return pool_[i >> POOL_BLOCK_BITS][i & ((1 << POOL_BLOCK_BITS) - 1)];
+  }
+
+  static constexpr int SKETCH_ROWS = 4;
+  static constexpr std::size_t SKETCH_WIDTH = 1 << 16;
+  std::unique_ptr<std::atomic<std::uint8_t>[]> sketch_;
+  std::atomic<std::uint64_t> sketch_additions_{0};
+
+  std::atomic<std::uint64_t> hits_{0};
+  std::atomic<std::uint64_t> subpath_hits_{0};
+  std::atomic<std::uint64_t> misses_{0};
+};
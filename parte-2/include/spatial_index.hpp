@@ -0,0 +1,42 @@
+#pragma once
+#include "graph_utils.hpp"
+#include <cstddef>
+#include <vector>
+
+/***
+ * Uniform grid over Graph::coords for nearest-node queries.
+ * Nodes are stored sorted by cell (CSR over cells) with their coordinates
+ * packed next to them, so a query only touches a few contiguous ranges.
+ * Distances use the same equirectangular projection as the A* heuristic.
+ */
+class SpatialIndex {
+public:
+  explicit SpatialIndex(const Graph &g);
+
+  // Nearest node to q (coordinates in microdegrees), -1 if the graph is empty
+  [[nodiscard]] int nearest(Coord q) const;
+
+  // Up to k nodes sorted by distance to q
+  [[nodiscard]] std::vector<int> k_nearest(Coord q, int k) const;
+
+  // out[i] = nearest(queries[i]), split across threads (0 = all cores)
+  void nearest_batch(const Coord *queries, int *out, std::size_t count,
+                     unsigned threads = 0) const;
+
+private:
+  int cell_x(int lon) const;
+  int cell_y(int lat) const;
+
+  // Visits the cells at Chebyshev distance r from (cx, cy)
+  template <typename F> void for_ring(int cx, int cy, int r, F &&visit) const;
+
+  int min_lon_;
+  int min_lat_;
+  int cell_size_; // cell side in microdegrees
+  int nx_;
+  int ny_;
+
+  std::vector<int> cell_ptr_; // cell c -> [cell_ptr_[c], cell_ptr_[c+1])
+  std::vector<int> ids_;
+  std::vector<Coord> points_;
+};
@@ -2,14 +2,55 @@
 import os
 import sys
 import subprocess
+import time
+from array import array
 from pathlib import Path
 
 
+def batch(pairs_file, map_name, output_file):
+    """Consultas en lote dentro del proceso (libpathfinder.so vía ctypes).
+
+    pairs_file: un par "<vertice-1> <vertice-2>" por línea.
+    output_file: "<vertice-1> <vertice-2> <coste>" por línea (-1 sin camino).
+    """
+    from pathfinder import Pathfinder, default_library
+
+    if not default_library().exists():
+        print(f"[ERROR]: no existe la librería: {default_library()}", file=sys.stderr)
+        return 1
+
+    starts, goals = array("i"), array("i")
+    with open(pairs_file) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) >= 2:
+                starts.append(int(fields[0]) - 1)
+                goals.append(int(fields[1]) - 1)
+
+    with Pathfinder(Path(map_name).resolve()) as pf:
+        start_time = time.perf_counter()
+        costs = pf.batch_costs(starts, goals)
+        elapsed = time.perf_counter() - start_time
+
+    with open(output_file, "w") as f:
+        for u, v, c in zip(starts, goals, costs):
+            f.write(f"{u + 1} {v + 1} {c}\n")
+
+    rate = len(costs) / elapsed if elapsed > 0 else float("inf")
+    print(f"[INFO]  {len(costs)} consultas en {elapsed:.3f}s ({rate:.0f} consultas/s)")
+    return 0
+
+
 def main():
-    if len(sys.argv) not in [5, 7]:
+    if len(sys.argv) == 5 and sys.argv[1] == "--batch":
+        return batch(sys.argv[2], sys.argv[3], sys.argv[4])
+
+    if len(sys.argv) < 5 or (len(sys.argv) - 5) % 2 != 0:
         print(
             "Uso: ./programa <vertice-1> <vertice-2> <nombre-del-mapa> <fichero-salida>\n",
-            "Opcional: --algorithm <algoritmo> (dijkstra | astar | both).\n",
+            "Opcional: --algorithm <algoritmo> (dijkstra | astar | both | wastar | anytime).\n",
+            "          --weight <w> --deadline <ms> (wastar | anytime).\n",
+            "Lote:     ./programa --batch <fichero-pares> <nombre-del-mapa> <fichero-salida>\n",
         )
         return 1
 
@@ -40,11 +81,9 @@ def main():
         print(f"[ERROR]: no existe el binario: {exe}", file=sys.stderr)
         return 1
 
-    # ejecutar: ./parte-2 u v map_name out_file
-    if len(sys.argv) == 7:
-        algorithm = sys.argv[6]
-
+    # ejecutar: ./parte-2 u v map_name out_file [opciones]
     cmd = [str(exe), u, v, map_path, output_file, "--algorithm", algorithm]
+    cmd += sys.argv[5:]
     return subprocess.call(cmd)
 
 
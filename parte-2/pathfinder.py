@@ -0,0 +1,238 @@
+#!/usr/bin/env python3
+"""Enlace ctypes con libpathfinder.so (API de C de include/pathfinder.h).
+
+El grafo se carga una sola vez y las consultas se hacen dentro del mismo
+proceso. Los resultados se escriben directamente en buffers de Python
+(array.array), sin copias intermedias.
+"""
+import ctypes
+from array import array
+from pathlib import Path
+
+_INT_P = ctypes.POINTER(ctypes.c_int)
+
+
+class CacheStats(ctypes.Structure):
+    _fields_ = [
+        ("hits", ctypes.c_ulonglong),
+        ("subpath_hits", ctypes.c_ulonglong),
+        ("misses", ctypes.c_ulonglong),
+        ("entries", ctypes.c_ulonglong),
+        ("bytes", ctypes.c_ulonglong),
+        ("capacity", ctypes.c_ulonglong),
+    ]
+
+_LLONG_P = ctypes.POINTER(ctypes.c_longlong)
+_DOUBLE_P = ctypes.POINTER(ctypes.c_double)
+
+
+def default_library():
+    return Path(__file__).resolve().parent / "build" / "libpathfinder.so"
+
+
+def _load_library(path):
+    lib = ctypes.CDLL(str(path))
+
+    lib.pf_graph_load.argtypes = [ctypes.c_char_p]
+    lib.pf_graph_load.restype = ctypes.c_void_p
+    lib.pf_graph_free.argtypes = [ctypes.c_void_p]
+    lib.pf_graph_free.restype = None
+    lib.pf_graph_nodes.argtypes = [ctypes.c_void_p]
+    lib.pf_graph_nodes.restype = ctypes.c_int
+
+    lib.pf_workspace_create.argtypes = [ctypes.c_void_p]
+    lib.pf_workspace_create.restype = ctypes.c_void_p
+    lib.pf_workspace_free.argtypes = [ctypes.c_void_p]
+    lib.pf_workspace_free.restype = None
+
+    lib.pf_query.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ctypes.c_int,
+        _INT_P,
+        ctypes.c_int,
+        _LLONG_P,
+    ]
+    lib.pf_query.restype = ctypes.c_int
+    lib.pf_batch_query.argtypes = [
+        ctypes.c_void_p,
+        _INT_P,
+        _INT_P,
+        _LLONG_P,
+        ctypes.c_int,
+        ctypes.c_int,
+    ]
+    lib.pf_batch_query.restype = ctypes.c_int
+
+    lib.pf_snap_batch.argtypes = [
+        ctypes.c_void_p,
+        _DOUBLE_P,
+        _DOUBLE_P,
+        _INT_P,
+        ctypes.c_int,
+        ctypes.c_int,
+    ]
+    lib.pf_snap_batch.restype = ctypes.c_int
+    lib.pf_nearest_k.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_double,
+        ctypes.c_double,
+        _INT_P,
+        ctypes.c_int,
+    ]
+    lib.pf_nearest_k.restype = ctypes.c_int
+
+    lib.pf_cache_enable.argtypes = [ctypes.c_void_p, ctypes.c_ulonglong]
+    lib.pf_cache_enable.restype = ctypes.c_int
+    lib.pf_cache_stats_get.argtypes = [ctypes.c_void_p, ctypes.POINTER(CacheStats)]
+    lib.pf_cache_stats_get.restype = ctypes.c_int
+    lib.pf_graph_set_weight.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ctypes.c_int,
+        ctypes.c_int,
+    ]
+    lib.pf_graph_set_weight.restype = ctypes.c_int
+    lib.pf_numa_enable.argtypes = [ctypes.c_void_p]
+    lib.pf_numa_enable.restype = ctypes.c_int
+    return lib
+
+
+def _pointer(buffer, ctype):
+    # Puntero al buffer de un array.array (sin copia)
+    return (ctype * len(buffer)).from_buffer(buffer) if len(buffer) else None
+
+
+class Pathfinder:
+    """Grafo cargado en memoria más un espacio de trabajo para consultas."""
+
+    def __init__(self, map_name, library=None):
+        # close() (vía __del__) debe funcionar aunque la carga falle
+        self._graph = self._ws = None
+        self._lib = _load_library(library or default_library())
+        self._graph = self._lib.pf_graph_load(str(map_name).encode())
+        if not self._graph:
+            raise RuntimeError(f"No se pudo cargar el mapa: {map_name}")
+        self._ws = self._lib.pf_workspace_create(self._graph)
+        # Buffer de camino reutilizado entre consultas
+        self._path = array("i", bytes(4 * 4096))
+
+    @property
+    def nodes(self):
+        return self._lib.pf_graph_nodes(self._graph)
+
+    def route(self, start, goal):
+        """Camino óptimo (ids 0-based) y coste; ([], -1) si no hay camino.
+
+        El camino es una vista del buffer interno: es válido hasta la
+        siguiente consulta (copiar con list() si hay que conservarlo).
+        """
+        cost = ctypes.c_longlong(-1)
+        while True:
+            length = self._lib.pf_query(
+                self._ws,
+                start,
+                goal,
+                _pointer(self._path, ctypes.c_int),
+                len(self._path),
+                ctypes.byref(cost),
+            )
+            if length < 0:
+                raise ValueError(f"Vértices fuera de rango: {start}, {goal}")
+            if length <= len(self._path):
+                return memoryview(self._path)[:length], cost.value
+            # Camino más largo que el buffer: se amplía y se repite
+            self._path = array("i", bytes(4 * length))
+
+    def batch_costs(self, starts, goals, threads=0):
+        """Costes de starts[i] -> goals[i] (-1 si no hay camino)."""
+        starts = starts if isinstance(starts, array) else array("i", starts)
+        goals = goals if isinstance(goals, array) else array("i", goals)
+        if len(starts) != len(goals):
+            raise ValueError("starts y goals deben tener la misma longitud")
+        costs = array("q", bytes(8 * len(starts)))
+        self._lib.pf_batch_query(
+            self._graph,
+            _pointer(starts, ctypes.c_int),
+            _pointer(goals, ctypes.c_int),
+            _pointer(costs, ctypes.c_longlong),
+            len(starts),
+            threads,
+        )
+        return costs
+
+    def snap(self, lats, lons, threads=0):
+        """Vértice más cercano (id 0-based) a cada punto (lat, lon) en grados."""
+        lats = lats if isinstance(lats, array) else array("d", lats)
+        lons = lons if isinstance(lons, array) else array("d", lons)
+        if len(lats) != len(lons):
+            raise ValueError("lats y lons deben tener la misma longitud")
+        nodes = array("i", bytes(4 * len(lats)))
+        self._lib.pf_snap_batch(
+            self._graph,
+            _pointer(lats, ctypes.c_double),
+            _pointer(lons, ctypes.c_double),
+            _pointer(nodes, ctypes.c_int),
+            len(lats),
+            threads,
+        )
+        return nodes
+
+    def nearest(self, lat, lon, k=1):
+        """Los k vértices más cercanos a (lat, lon), del más próximo al más lejano."""
+        nodes = array("i", bytes(4 * max(k, 0)))
+        count = self._lib.pf_nearest_k(
+            self._graph, lat, lon, _pointer(nodes, ctypes.c_int), k
+        )
+        if count < 0:
+            raise ValueError(f"k no válido: {k}")
+        return nodes[:count]
+
+    def enable_cache(self, max_bytes):
+        """Caché de rutas compartida por todas las consultas (0 la desactiva)."""
+        if self._lib.pf_cache_enable(self._graph, max_bytes) != 0:
+            raise MemoryError("No se pudo crear la caché de rutas")
+
+    def cache_stats(self):
+        stats = CacheStats()
+        self._lib.pf_cache_stats_get(self._graph, ctypes.byref(stats))
+        return {name: getattr(stats, name) for name, _ in CacheStats._fields_}
+
+    def enable_numa(self):
+        """Réplica del grafo en cada nodo NUMA para batch_costs.
+
+        Devuelve el número de nodos NUMA usados (1 si la máquina no es NUMA:
+        en ese caso no se copia nada).
+        """
+        nodes = self._lib.pf_numa_enable(self._graph)
+        if nodes < 0:
+            raise RuntimeError("No se pudo replicar el grafo")
+        return nodes
+
+    def set_weight(self, u, v, weight):
+        """Cambia el peso de los arcos u -> v (invalida la caché).
+
+        El peso no puede ser negativo ni menor que la distancia en línea
+        recta entre u y v que estima la heurística.
+        """
+        updated = self._lib.pf_graph_set_weight(self._graph, u, v, weight)
+        if updated < 0:
+            raise ValueError(f"Vértices o peso no válidos: {u}, {v}, {weight}")
+        return updated
+
+    def close(self):
+        if self._ws:
+            self._lib.pf_workspace_free(self._ws)
+            self._ws = None
+        if self._graph:
+            self._lib.pf_graph_free(self._graph)
+            self._graph = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __del__(self):
+        self.close()
@@ -1,12 +1,10 @@
 #include "algorithm.hpp"
 #include "node.hpp"
 #include <algorithm>
+#include <cassert>
 #include <chrono>
 #include <cmath>
 
-// Large constant for initialization
-const int INF_INT = 2000000000;
-
 // CONVERSION FACTOR: Microdegrees to Decimeters
 // Calculation:
 // Earth Radius (R) = 6,371,000 meters = 63,710,000 decimeters.
@@ -22,15 +20,9 @@ const double ADMISSIBILITY_FACTOR = 0.999;
 
 const double FINAL_FACTOR = MICRODEG_TO_DECIMETERS * ADMISSIBILITY_FACTOR;
 
-/**
- * Scaled Euclidean Heuristic (Fast Mode).
- * Assumes the graph is in integer coordinates (microdegrees)
- * and weights are in decimeters.
- */
-int Algorithm::h(int n, double cos_lat_goal) {
-  const Coord &a = graph_.coords[n];
-  const Coord &b = graph_.coords[goal_];
-
+// Projected distance a -> b in decimeters (see h below)
+static int projected_distance(const Coord &a, const Coord &b,
+                              double cos_lat_goal) {
   // 1. Direct differences (in microdegrees)
   long long dlat = std::abs(a.lat - b.lat);
   long long dlon = std::abs(a.lon - b.lon);
@@ -50,9 +42,28 @@ int Algorithm::h(int n, double cos_lat_goal) {
   return static_cast<int>(dist_raw * FINAL_FACTOR);
 }
 
+/**
+ * Scaled Euclidean Heuristic (Fast Mode).
+ * Assumes the graph is in integer coordinates (microdegrees)
+ * and weights are in decimeters.
+ */
+int Algorithm::h(int n, double cos_lat_goal) {
+  return projected_distance(graph_.coords[n], graph_.coords[goal_],
+                            cos_lat_goal);
+}
+
+int Algorithm::min_arc_weight(const Graph &g, int u, int v) {
+  double cos_lat_v = std::cos((g.coords[v].lat / 1000000.0) * (M_PI / 180.0));
+  return projected_distance(g.coords[u], g.coords[v], cos_lat_v);
+}
+
 AlgorithmResult Algorithm::run() {
   auto start_time = std::chrono::high_resolution_clock::now();
 
+  // 0. Different components: answered without searching
+  if (!graph_.maybe_reachable(start_, goal_))
+    return AlgorithmResult{{}, static_cast<double>(INF_INT), 0, 0};
+
   // 1. Precompute the cosine of the goal's latitude for the projection
   // Convert from microdegrees to radians: (lat / 10^6) * (PI / 180)
   double lat_rad = (graph_.coords[goal_].lat / 1000000.0) * (M_PI / 180.0);
@@ -61,6 +72,7 @@ AlgorithmResult Algorithm::run() {
   // 2. Reset data structures
   std::fill(g_.begin(), g_.end(), INF_INT);
   std::fill(parent_.begin(), parent_.end(), -1);
+  std::fill(parent_arc_.begin(), parent_arc_.end(), -1);
   std::fill(closed_.begin(), closed_.end(), 0);
 
   open_.clear();
@@ -103,6 +115,7 @@ AlgorithmResult Algorithm::run() {
       if (new_g < g_[v]) {
         g_[v] = new_g;
         parent_[v] = u;
+        parent_arc_[v] = edge_idx;
 
         int f = new_g + h(v, cos_lat_goal);
         open_.push(v, f);
@@ -112,31 +125,32 @@ AlgorithmResult Algorithm::run() {
 
   // 5. Path reconstruction
   std::vector<int> path;
+  std::vector<int> arcs;
   int total_cost = g_[goal_];
 
-  if (total_cost != INF_INT) {
-    int u = goal_;
-    while (u != -1) {
-      path.push_back(u);
-      u = parent_[u];
-    }
-    std::reverse(path.begin(), path.end());
-  }
+  if (total_cost != INF_INT)
+    reconstruct_path(goal_, path, arcs);
 
   auto end_time = std::chrono::high_resolution_clock::now();
   auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time -
                                                                   start_time)
                 .count();
-  return AlgorithmResult{path, static_cast<double>(total_cost), expansions, ms};
+  AlgorithmResult result{path, static_cast<double>(total_cost), expansions, ms};
+  result.arcs = std::move(arcs);
+  return result;
 }
 
 // Dijkstra Algorithm for comparison
 AlgorithmResult Algorithm::run_dijkstra() {
   auto start_time = std::chrono::high_resolution_clock::now();
 
+  if (!graph_.maybe_reachable(start_, goal_))
+    return AlgorithmResult{{}, INF, 0, 0};
+
   // Reset data structures
   std::fill(g_.begin(), g_.end(), INF);
   std::fill(parent_.begin(), parent_.end(), -1);
+  std::fill(parent_arc_.begin(), parent_arc_.end(), -1);
   std::fill(closed_.begin(), closed_.end(), 0);
   open_.clear();
 
@@ -172,6 +186,7 @@ AlgorithmResult Algorithm::run_dijkstra() {
       if (!closed_[v] && new_g < g_[v]) {
         g_[v] = new_g;
         parent_[v] = u;
+        parent_arc_[v] = idx;
         open_.push(v, new_g);
       }
     }
@@ -179,16 +194,640 @@ AlgorithmResult Algorithm::run_dijkstra() {
 
   // Reconstruct path
   std::vector<int> path;
+  std::vector<int> arcs;
   double total_cost = g_[goal_];
-  if (total_cost < INF) {
-    for (int u = goal_; u != -1; u = parent_[u])
-      path.push_back(u);
-    std::reverse(path.begin(), path.end());
+  if (total_cost < INF)
+    reconstruct_path(goal_, path, arcs);
+
+  auto end_time = std::chrono::high_resolution_clock::now();
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time -
+                                                                  start_time)
+                .count();
+  AlgorithmResult result{path, total_cost, expansions, ms};
+  result.arcs = std::move(arcs);
+  return result;
+}
+
+// Path reconstruction from parent_ / parent_arc_ (target must have been
+// reached). arcs[i] is the CSR arc from path[i] to path[i + 1].
+void Algorithm::reconstruct_path(int target, std::vector<int> &path,
+                                 std::vector<int> &arcs) const {
+  path.clear();
+  arcs.clear();
+  for (int u = target; u != -1; u = parent_[u]) {
+    path.push_back(u);
+    if (parent_[u] != -1)
+      arcs.push_back(parent_arc_[u]);
+  }
+  std::reverse(path.begin(), path.end());
+  std::reverse(arcs.begin(), arcs.end());
+}
+
+int Algorithm::weighted_search(double w, int incumbent,
+                               Clock::time_point deadline,
+                               std::size_t &expansions, bool &timed_out) {
+  if (!graph_.maybe_reachable(start_, goal_))
+    return incumbent;
+
+  double lat_rad = (graph_.coords[goal_].lat / 1000000.0) * (M_PI / 180.0);
+  double cos_lat_goal = std::cos(lat_rad);
+
+  std::fill(g_.begin(), g_.end(), INF_INT);
+  std::fill(parent_.begin(), parent_.end(), -1);
+  std::fill(parent_arc_.begin(), parent_arc_.end(), -1);
+  std::fill(closed_.begin(), closed_.end(), 0);
+  open_.clear();
+
+  // f = g + w·h overflows int for large weights: computed in double and
+  // saturated at INF_INT (still above the cost of any real path, so the
+  // bound w is kept)
+  auto weighted_f = [w](int g, int hv) {
+    double f = g + w * hv;
+    return f < INF_INT ? static_cast<int>(f) : INF_INT;
+  };
+
+  g_[start_] = 0;
+  open_.push(start_, weighted_f(0, h(start_, cos_lat_goal)));
+
+  std::size_t local_expansions = 0;
+  while (!open_.empty()) {
+    int u = open_.pop();
+
+    if (closed_[u])
+      continue;
+
+    closed_[u] = 1;
+    expansions++;
+
+    if (u == goal_)
+      return static_cast<int>(g_[goal_]);
+
+    // Checking the clock on every expansion would dominate the loop
+    if ((++local_expansions & 1023) == 0 && Clock::now() >= deadline) {
+      timed_out = true;
+      return incumbent;
+    }
+
+    auto [begin, end] = graph_.neighbours(u);
+    int gu = g_[u];
+    int idx = graph_.row_ptr[u];
+
+    for (auto it = begin; it != end; ++it, ++idx) {
+      int v = *it;
+      int new_g = gu + graph_.weights[idx];
+
+      // No re-expansions: with a consistent h the result stays within w
+      if (closed_[v] || new_g >= g_[v])
+        continue;
+
+      // Prune with the admissible h: v cannot lead to a better solution
+      int hv = h(v, cos_lat_goal);
+      if (static_cast<long long>(new_g) + hv >= incumbent)
+        continue;
+
+      g_[v] = new_g;
+      parent_[v] = u;
+      parent_arc_[v] = idx;
+      open_.push(v, weighted_f(new_g, hv));
+    }
+  }
+
+  return incumbent;
+}
+
+// Weighted A* for bounded-suboptimal queries
+AlgorithmResult Algorithm::run_weighted(double w) {
+  auto start_time = Clock::now();
+
+  std::size_t expansions = 0;
+  bool timed_out = false;
+  int cost = weighted_search(w, INF_INT, Clock::time_point::max(), expansions,
+                             timed_out);
+
+  std::vector<int> path;
+  std::vector<int> arcs;
+  if (cost != INF_INT)
+    reconstruct_path(goal_, path, arcs);
+
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                Clock::now() - start_time)
+                .count();
+  AlgorithmResult result{path, static_cast<double>(cost), expansions, ms, w};
+  result.arcs = std::move(arcs);
+  return result;
+}
+
+// Anytime weighted A* (restarting variant). Each pass halves the distance of
+// w to 1 and only keeps nodes that can beat the incumbent. The first pass
+// ignores the deadline so a solution is always returned when one exists.
+AlgorithmResult Algorithm::run_anytime(double w, long long deadline_ms) {
+  auto start_time = Clock::now();
+  auto deadline = start_time + std::chrono::milliseconds(deadline_ms);
+
+  std::size_t expansions = 0;
+  std::vector<int> best_path;
+  std::vector<int> best_arcs;
+  int best_cost = INF_INT;
+  double bound = w;
+
+  bool timed_out = false;
+  bool first = true;
+  while (!timed_out) {
+    int cost = weighted_search(
+        w, best_cost, first ? Clock::time_point::max() : deadline, expansions,
+        timed_out);
+
+    if (timed_out)
+      break;
+
+    if (cost < best_cost) {
+      best_cost = cost;
+      reconstruct_path(goal_, best_path, best_arcs);
+    }
+    // Unreachable goal: further passes cannot find anything
+    if (best_cost == INF_INT)
+      break;
+
+    bound = w;
+    if (w <= 1.0)
+      break;
+
+    w = 1.0 + (w - 1.0) / 2.0;
+    if (w < 1.01)
+      w = 1.0;
+    first = false;
+  }
+
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                Clock::now() - start_time)
+                .count();
+  AlgorithmResult result{best_path, static_cast<double>(best_cost), expansions,
+                        ms, bound};
+  result.arcs = std::move(best_arcs);
+  return result;
+}
+
+// ALTERNATIVE ROUTES (via-node method)
+// Maximum cost of an alternative relative to the optimal one
+const double ALT_STRETCH = 0.25;
+// Maximum length shared with the optimal route (and the chosen ones)
+const double ALT_SHARING = 0.8;
+// Fraction of the route that must be locally optimal around the via node
+const double ALT_LOCAL_OPT = 0.25;
+// Plateaus evaluated before giving up (each one builds a full route)
+const int ALT_MAX_CANDIDATES = 64;
+// T-tests run before giving up (each one is a small Dijkstra)
+const int ALT_MAX_TESTS = 8;
+
+// True if the shortest x -> y distance equals `length`, i.e. the subpath of
+// the candidate between x and y has no shortcut. Uses closed_back_ as the
+// closed set (the backward search is finished by then).
+bool Algorithm::locally_optimal(int x, int y, double length,
+                                std::size_t &expansions) {
+  std::vector<int> touched;
+  open_.clear();
+  local_g_[x] = 0.0;
+  touched.push_back(x);
+  open_.push(x, 0);
+
+  double found = INF;
+  while (!open_.empty()) {
+    int u = open_.pop();
+    if (closed_back_[u])
+      continue;
+    double gu = local_g_[u];
+    if (gu > length)
+      break;
+    if (u == y) {
+      found = gu;
+      break;
+    }
+    closed_back_[u] = 1;
+    expansions++;
+
+    auto [begin, end] = graph_.neighbours(u);
+    int idx = graph_.row_ptr[u];
+    for (auto it = begin; it != end; ++it, ++idx) {
+      int v = *it;
+      double new_g = gu + graph_.weights[idx];
+      if (new_g < local_g_[v] && new_g <= length) {
+        if (local_g_[v] == INF)
+          touched.push_back(v);
+        local_g_[v] = new_g;
+        open_.push(v, static_cast<int>(new_g));
+      }
+    }
+  }
+
+  for (int u : touched) {
+    local_g_[u] = INF;
+    closed_back_[u] = 0;
+  }
+  return found >= length;
+}
+
+// Length of the arcs of p (with cumulative distances d) that also belong to q
+double Algorithm::shared_length(const std::vector<int> &p,
+                                const std::vector<double> &d,
+                                const std::vector<int> &q) {
+  for (std::size_t i = 0; i + 1 < q.size(); i++)
+    via_next_[q[i]] = q[i + 1];
+
+  double shared = 0.0;
+  for (std::size_t i = 0; i + 1 < p.size(); i++)
+    if (via_next_[p[i]] == p[i + 1])
+      shared += d[i + 1] - d[i];
+
+  for (std::size_t i = 0; i + 1 < q.size(); i++)
+    via_next_[q[i]] = -1;
+  return shared;
+}
+
+AlgorithmResult Algorithm::run_alternatives(const Graph &reverse, int k) {
+  auto start_time = std::chrono::high_resolution_clock::now();
+
+  if (!graph_.maybe_reachable(start_, goal_))
+    return AlgorithmResult{{}, INF, 0, 0};
+
+  // mu and meet are only updated when an arc is relaxed: the empty route
+  // would never be found (and every alternative would be a loop)
+  if (start_ == goal_)
+    return AlgorithmResult{{start_}, 0.0, 0, 0};
+
+  // Lazy allocation: plain queries never pay for the backward state
+  if (g_back_.empty()) {
+    closed_back_.assign(graph_.n, 0);
+    g_back_.assign(graph_.n, INF);
+    parent_back_.assign(graph_.n, -1);
+    via_next_.assign(graph_.n, -1);
+    local_g_.assign(graph_.n, INF);
+  }
+
+  std::fill(g_.begin(), g_.end(), INF);
+  std::fill(parent_.begin(), parent_.end(), -1);
+  std::fill(closed_.begin(), closed_.end(), 0);
+  std::fill(g_back_.begin(), g_back_.end(), INF);
+  std::fill(parent_back_.begin(), parent_back_.end(), -1);
+  std::fill(closed_back_.begin(), closed_back_.end(), 0);
+  open_.clear();
+  open_back_.clear();
+  settled_.clear();
+
+  std::size_t expansions = 0;
+
+  // 1. Bidirectional Dijkstra. Each side keeps going until its key exceeds
+  // (1 + ALT_STRETCH) * mu, so both search spaces cover every via node
+  // that can yield an admissible alternative.
+  double mu = INF;
+  int meet = -1;
+
+  g_[start_] = 0.0;
+  g_back_[goal_] = 0.0;
+  open_.push(start_, 0);
+  open_back_.push(goal_, 0);
+
+  bool forward_done = false;
+  bool backward_done = false;
+  while (!forward_done || !backward_done) {
+    if (!forward_done) {
+      int u = open_.pop();
+      if (u == -1 || g_[u] > (1.0 + ALT_STRETCH) * mu) {
+        forward_done = true;
+      } else if (!closed_[u]) {
+        closed_[u] = 1;
+        settled_.push_back(u);
+        expansions++;
+
+        auto [begin, end] = graph_.neighbours(u);
+        int idx = graph_.row_ptr[u];
+        for (auto it = begin; it != end; ++it, ++idx) {
+          int v = *it;
+          double new_g = g_[u] + graph_.weights[idx];
+          if (!closed_[v] && new_g < g_[v]) {
+            g_[v] = new_g;
+            parent_[v] = u;
+            open_.push(v, static_cast<int>(new_g));
+          }
+          if (new_g + g_back_[v] < mu) {
+            mu = new_g + g_back_[v];
+            meet = v;
+          }
+        }
+      }
+    }
+
+    if (!backward_done) {
+      int u = open_back_.pop();
+      if (u == -1 || g_back_[u] > (1.0 + ALT_STRETCH) * mu) {
+        backward_done = true;
+      } else if (!closed_back_[u]) {
+        closed_back_[u] = 1;
+        expansions++;
+
+        auto [begin, end] = reverse.neighbours(u);
+        int idx = reverse.row_ptr[u];
+        for (auto it = begin; it != end; ++it, ++idx) {
+          int v = *it;
+          double new_g = g_back_[u] + reverse.weights[idx];
+          if (!closed_back_[v] && new_g < g_back_[v]) {
+            g_back_[v] = new_g;
+            parent_back_[v] = u;
+            open_back_.push(v, static_cast<int>(new_g));
+          }
+          if (new_g + g_[v] < mu) {
+            mu = new_g + g_[v];
+            meet = v;
+          }
+        }
+      }
+    }
   }
 
+  if (meet == -1) {
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::high_resolution_clock::now() - start_time)
+                  .count();
+    return AlgorithmResult{{}, INF, expansions, ms};
+  }
+
+  // Route through a via node: forward tree to v, backward tree from v.
+  // `d` receives the cumulative cost of every node.
+  auto via_route = [&](int v, std::vector<int> &p, std::vector<double> &d) {
+    p.clear();
+    d.clear();
+    for (int u = v; u != -1; u = parent_[u])
+      p.push_back(u);
+    std::reverse(p.begin(), p.end());
+    for (int u : p)
+      d.push_back(g_[u]);
+    for (int u = parent_back_[v]; u != -1; u = parent_back_[u]) {
+      p.push_back(u);
+      d.push_back(g_[v] + g_back_[v] - g_back_[u]);
+    }
+  };
+
+  std::vector<int> best_path;
+  std::vector<double> best_dist;
+  via_route(meet, best_path, best_dist);
+
+  // 2. Plateaus: maximal subpaths shared by both shortest path trees (hence
+  // shortest paths themselves). Every via node of a plateau yields the same
+  // route, so plateaus are the real candidates. closed_ marks the nodes of
+  // plateaus already built and the optimal route.
+  std::fill(closed_.begin(), closed_.end(), 0);
+  for (int u : best_path)
+    closed_[u] = 1;
+
+  struct Plateau {
+    int via;
+    double length;
+  };
+  std::vector<Plateau> plateaus;
+  for (int v : settled_) {
+    if (closed_[v] || !closed_back_[v] ||
+        g_[v] + g_back_[v] > (1.0 + ALT_STRETCH) * mu)
+      continue;
+
+    int a = v;
+    while (parent_[a] != -1 && parent_back_[parent_[a]] == a)
+      a = parent_[a];
+    int b = v;
+    while (parent_back_[b] != -1 && parent_[parent_back_[b]] == b)
+      b = parent_back_[b];
+    for (int u = a; u != b; u = parent_back_[u])
+      closed_[u] = 1;
+    closed_[b] = 1;
+
+    plateaus.push_back({v, g_[b] - g_[a]});
+  }
+
+  // Long plateaus first: they are the most likely to be locally optimal
+  std::sort(plateaus.begin(), plateaus.end(),
+            [](const Plateau &x, const Plateau &y) {
+              return x.length > y.length;
+            });
+
+  // 3. Admissibility filters: simple path, limited sharing, local optimality.
+  // closed_back_ becomes the closed set of the T-tests.
+  std::fill(closed_back_.begin(), closed_back_.end(), 0);
+
+  std::vector<AlternativeRoute> alternatives;
+  std::vector<int> p;
+  std::vector<double> d;
+  int evaluated = 0;
+  int tested = 0;
+
+  for (const Plateau &pl : plateaus) {
+    if (static_cast<int>(alternatives.size()) >= k ||
+        evaluated >= ALT_MAX_CANDIDATES)
+      break;
+    evaluated++;
+
+    int v = pl.via;
+    via_route(v, p, d);
+    double length = d.back();
+
+    // Loops appear when both trees share nodes around v
+    bool simple = true;
+    for (int u : p) {
+      if (via_next_[u] == -2) {
+        simple = false;
+        break;
+      }
+      via_next_[u] = -2;
+    }
+    for (int u : p)
+      via_next_[u] = -1;
+    if (!simple)
+      continue;
+
+    // Sharing with the optimal route and the alternatives already chosen
+    bool distinct = shared_length(p, d, best_path) <= ALT_SHARING * mu;
+    for (std::size_t i = 0; distinct && i < alternatives.size(); i++)
+      distinct = shared_length(p, d, alternatives[i].path) <= ALT_SHARING * mu;
+    if (!distinct)
+      continue;
+
+    // T-test: the subpath spanning T before and after v must be shortest.
+    // A long enough plateau already guarantees it.
+    double t = ALT_LOCAL_OPT * length;
+    if (pl.length < t) {
+      if (tested >= ALT_MAX_TESTS)
+        continue;
+      tested++;
+
+      std::size_t iv = std::find(p.begin(), p.end(), v) - p.begin();
+      std::size_t ix = iv;
+      while (ix > 0 && d[iv] - d[ix] < t)
+        ix--;
+      std::size_t iy = iv;
+      while (iy + 1 < p.size() && d[iy] - d[iv] < t)
+        iy++;
+      if (!locally_optimal(p[ix], p[iy], d[iy] - d[ix], expansions))
+        continue;
+    }
+
+    alternatives.push_back({p, length});
+  }
+
+  std::sort(alternatives.begin(), alternatives.end(),
+            [](const AlternativeRoute &x, const AlternativeRoute &y) {
+              return x.cost < y.cost;
+            });
+
   auto end_time = std::chrono::high_resolution_clock::now();
   auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time -
                                                                   start_time)
                 .count();
-  return AlgorithmResult{path, total_cost, expansions, ms};
-}
\ No newline at end of file
+  AlgorithmResult result{best_path, mu, expansions, ms};
+  result.alternatives = std::move(alternatives);
+  return result;
+}
+
+// MULTI-SOURCE / MULTI-TARGET
+// Up to this many targets the heuristic is the exact minimum over them;
+// beyond it, the distance to their bounding box (cheaper, still consistent)
+const std::size_t MULTI_EXACT_TARGETS = 16;
+
+AlgorithmResult Algorithm::run_multi(const std::vector<int> &sources,
+                                     const std::vector<int> &offsets,
+                                     const std::vector<int> &targets,
+                                     const std::vector<int> &target_offsets) {
+  auto start_time = std::chrono::high_resolution_clock::now();
+
+  // Sources that cannot reach any target are dropped without searching
+  std::vector<int> seeds;
+  for (std::size_t i = 0; i < sources.size(); i++) {
+    for (int t : targets) {
+      if (graph_.maybe_reachable(sources[i], t)) {
+        seeds.push_back(static_cast<int>(i));
+        break;
+      }
+    }
+  }
+  if (seeds.empty())
+    return AlgorithmResult{{}, static_cast<double>(INF_INT), 0, 0};
+
+  // Heuristic: minimum over the targets (or their bounding box)
+  std::vector<double> cos_lat(targets.size());
+  int min_lat = graph_.coords[targets[0]].lat, max_lat = min_lat;
+  int min_lon = graph_.coords[targets[0]].lon, max_lon = min_lon;
+  double min_cos = 1.0;
+  for (std::size_t i = 0; i < targets.size(); i++) {
+    const Coord &c = graph_.coords[targets[i]];
+    cos_lat[i] = std::cos((c.lat / 1000000.0) * (M_PI / 180.0));
+    min_cos = std::min(min_cos, cos_lat[i]);
+    min_lat = std::min(min_lat, c.lat);
+    max_lat = std::max(max_lat, c.lat);
+    min_lon = std::min(min_lon, c.lon);
+    max_lon = std::max(max_lon, c.lon);
+  }
+
+  auto h_multi = [&](int n) {
+    const Coord &a = graph_.coords[n];
+    if (targets.size() > MULTI_EXACT_TARGETS) {
+      // Smallest cosine: the projection never overestimates
+      double dlat = std::max({0, min_lat - a.lat, a.lat - max_lat});
+      double dlon = std::max({0, min_lon - a.lon, a.lon - max_lon}) * min_cos;
+      return static_cast<int>(std::sqrt(dlat * dlat + dlon * dlon) *
+                              FINAL_FACTOR);
+    }
+    int best = INF_INT;
+    for (std::size_t i = 0; i < targets.size(); i++) {
+      const Coord &b = graph_.coords[targets[i]];
+      double dlat = static_cast<double>(a.lat) - b.lat;
+      double dlon = (static_cast<double>(a.lon) - b.lon) * cos_lat[i];
+      best = std::min(best, static_cast<int>(std::sqrt(dlat * dlat +
+                                                       dlon * dlon) *
+                                             FINAL_FACTOR));
+    }
+    return best;
+  };
+
+  // Reset data structures
+  std::fill(g_.begin(), g_.end(), INF_INT);
+  std::fill(parent_.begin(), parent_.end(), -1);
+  std::fill(parent_arc_.begin(), parent_arc_.end(), -1);
+  std::fill(closed_.begin(), closed_.end(), 0);
+  open_.clear();
+
+  if (target_offset_.empty())
+    target_offset_.assign(graph_.n, -1);
+  for (std::size_t i = 0; i < targets.size(); i++) {
+    int offset = target_offsets.empty() ? 0 : target_offsets[i];
+    assert(offset >= 0);
+    int &mark = target_offset_[targets[i]];
+    mark = (mark == -1) ? offset : std::min(mark, offset);
+  }
+
+  // Every source starts at its offset (e.g. time to reach the depot)
+  for (int i : seeds) {
+    int s = sources[i];
+    int offset = offsets.empty() ? 0 : offsets[i];
+    assert(offset >= 0); // f indexes the OpenList buckets
+    if (offset < g_[s]) {
+      g_[s] = offset;
+      open_.push(s, offset + h_multi(s));
+    }
+  }
+
+  std::size_t expansions = 0;
+  int reached = -1;
+  int total_cost = INF_INT;
+
+  while (!open_.empty()) {
+    int u = open_.pop();
+
+    if (closed_[u])
+      continue;
+
+    // Nothing left can beat the best target (with its offset). Without
+    // offsets this stops right after the first target settled.
+    if (total_cost != INF_INT && g_[u] + h_multi(u) >= total_cost)
+      break;
+
+    closed_[u] = 1;
+    expansions++;
+
+    if (target_offset_[u] != -1 && g_[u] + target_offset_[u] < total_cost) {
+      reached = u;
+      total_cost = g_[u] + target_offset_[u];
+    }
+
+    auto [begin, end] = graph_.neighbours(u);
+    int gu = g_[u];
+    int idx = graph_.row_ptr[u];
+
+    for (auto it = begin; it != end; ++it, ++idx) {
+      int v = *it;
+      int new_g = gu + graph_.weights[idx];
+
+      if (new_g < g_[v]) {
+        g_[v] = new_g;
+        parent_[v] = u;
+        parent_arc_[v] = idx;
+        open_.push(v, new_g + h_multi(v));
+      }
+    }
+  }
+
+  for (int t : targets)
+    target_offset_[t] = -1;
+
+  std::vector<int> path;
+  std::vector<int> arcs;
+  if (reached != -1)
+    reconstruct_path(reached, path, arcs);
+
+  auto end_time = std::chrono::high_resolution_clock::now();
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time -
+                                                                  start_time)
+                .count();
+  AlgorithmResult result{path, static_cast<double>(total_cost), expansions, ms};
+  result.arcs = std::move(arcs);
+  if (reached != -1) {
+    result.source = path.front();
+    result.target = reached;
+  }
+  return result;
+}
@@ -0,0 +1,275 @@
+#include "graph_components.hpp"
+#include "logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <utility>
+
+namespace GraphComponents {
+
+// File header to detect stale or foreign index files
+static const char SCC_MAGIC[4] = {'S', 'C', 'C', '2'};
+
+// FNV-1a over the topology (row_ptr, col_idx): a map regenerated with the
+// same size but different arcs must not reuse the index
+static std::uint64_t topology_checksum(const Graph &g) {
+  std::uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash](int x) {
+    auto v = static_cast<std::uint32_t>(x);
+    for (int i = 0; i < 4; i++) {
+      hash ^= (v >> (8 * i)) & 0xff;
+      hash *= 1099511628211ull;
+    }
+  };
+  for (int x : g.row_ptr)
+    mix(x);
+  for (int x : g.col_idx)
+    mix(x);
+  return hash;
+}
+
+static int find_root(std::vector<int> &parent, int x) {
+  while (parent[x] != x) {
+    parent[x] = parent[parent[x]]; // path halving
+    x = parent[x];
+  }
+  return x;
+}
+
+int compute(Graph &g) {
+  const int n = g.n;
+  std::vector<int> index(n, -1);
+  std::vector<int> low(n, 0);
+  g.component.assign(n, -1);
+
+  // Tarjan stack and explicit DFS stack (node, next arc to visit), so that
+  // long road chains do not overflow the call stack.
+  std::vector<int> stack;
+  std::vector<std::pair<int, int>> frames;
+
+  int counter = 0;
+  int n_comp = 0;
+
+  for (int s = 0; s < n; s++) {
+    if (index[s] != -1)
+      continue;
+
+    index[s] = low[s] = counter++;
+    stack.push_back(s);
+    frames.push_back({s, g.row_ptr[s]});
+
+    while (!frames.empty()) {
+      int u = frames.back().first;
+      int e = frames.back().second;
+
+      if (e < g.row_ptr[u + 1]) {
+        frames.back().second++;
+        int v = g.col_idx[e];
+
+        if (index[v] == -1) {
+          index[v] = low[v] = counter++;
+          stack.push_back(v);
+          frames.push_back({v, g.row_ptr[v]});
+        } else if (g.component[v] == -1) {
+          // v still on the Tarjan stack
+          low[u] = std::min(low[u], index[v]);
+        }
+        continue;
+      }
+
+      // All arcs of u visited
+      frames.pop_back();
+      if (low[u] == index[u]) {
+        int w;
+        do {
+          w = stack.back();
+          stack.pop_back();
+          g.component[w] = n_comp;
+        } while (w != u);
+        n_comp++;
+      }
+      if (!frames.empty()) {
+        int p = frames.back().first;
+        low[p] = std::min(low[p], low[u]);
+      }
+    }
+  }
+
+  // Weakly connected groups: union of components joined by any arc
+  std::vector<int> parent(n_comp);
+  std::iota(parent.begin(), parent.end(), 0);
+  for (int u = 0; u < n; u++) {
+    int cu = g.component[u];
+    auto [begin, end] = g.neighbours(u);
+    for (auto it = begin; it != end; ++it) {
+      int cv = g.component[*it];
+      if (cu != cv) {
+        int ru = find_root(parent, cu);
+        int rv = find_root(parent, cv);
+        if (ru != rv)
+          parent[ru] = rv;
+      }
+    }
+  }
+
+  g.component_group.resize(n_comp);
+  for (int c = 0; c < n_comp; c++)
+    g.component_group[c] = find_root(parent, c);
+
+  return n_comp;
+}
+
+bool load(Graph &g, const std::string &filename) {
+  std::ifstream fin(filename, std::ios::binary);
+  if (!fin.is_open())
+    return false;
+
+  char magic[4];
+  int n = 0, m = 0, n_comp = 0;
+  std::uint64_t checksum = 0;
+  fin.read(magic, sizeof(magic));
+  fin.read(reinterpret_cast<char *>(&n), sizeof(n));
+  fin.read(reinterpret_cast<char *>(&m), sizeof(m));
+  fin.read(reinterpret_cast<char *>(&n_comp), sizeof(n_comp));
+  fin.read(reinterpret_cast<char *>(&checksum), sizeof(checksum));
+
+  if (!fin || std::memcmp(magic, SCC_MAGIC, sizeof(magic)) != 0 ||
+      n != g.n || m != g.m || n_comp < 0 || checksum != topology_checksum(g))
+    return false;
+
+  std::vector<int> component(n);
+  std::vector<int> component_group(n_comp);
+  fin.read(reinterpret_cast<char *>(component.data()),
+           sizeof(int) * static_cast<std::size_t>(n));
+  fin.read(reinterpret_cast<char *>(component_group.data()),
+           sizeof(int) * static_cast<std::size_t>(n_comp));
+  if (!fin)
+    return false;
+
+  g.component = std::move(component);
+  g.component_group = std::move(component_group);
+  return true;
+}
+
+bool save(const Graph &g, const std::string &filename) {
+  std::ofstream fout(filename, std::ios::binary);
+  if (!fout.is_open())
+    return false;
+
+  int n_comp = static_cast<int>(g.component_group.size());
+  fout.write(SCC_MAGIC, sizeof(SCC_MAGIC));
+  fout.write(reinterpret_cast<const char *>(&g.n), sizeof(g.n));
+  fout.write(reinterpret_cast<const char *>(&g.m), sizeof(g.m));
+  fout.write(reinterpret_cast<const char *>(&n_comp), sizeof(n_comp));
+  std::uint64_t checksum = topology_checksum(g);
+  fout.write(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+  fout.write(reinterpret_cast<const char *>(g.component.data()),
+             sizeof(int) * g.component.size());
+  fout.write(reinterpret_cast<const char *>(g.component_group.data()),
+             sizeof(int) * g.component_group.size());
+  return static_cast<bool>(fout);
+}
+
+void load_or_compute(Graph &g, const std::string &filename) {
+  if (load(g, filename)) {
+    Logger::info("Componentes cargadas de " + filename + " (" +
+                 Logger::fmt_int(g.component_group.size()) + ")");
+    return;
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+  int n_comp = compute(g);
+  auto end = std::chrono::high_resolution_clock::now();
+  long long ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - start)
+          .count();
+
+  Logger::info("Componentes calculadas en " + Logger::fmt_int(ms) + " ms (" +
+               Logger::fmt_int(n_comp) + ")");
+
+  // A read-only map directory is not an error: the index is just rebuilt
+  if (!save(g, filename))
+    Logger::info("No se pudo guardar el índice de componentes: " + filename);
+}
+
+int largest(const Graph &g) {
+  std::vector<int> size(g.component_group.size(), 0);
+  for (int c : g.component)
+    size[c]++;
+  return static_cast<int>(std::max_element(size.begin(), size.end()) -
+                          size.begin());
+}
+
+Graph extract(const Graph &g, int comp, std::vector<int> &original_ids) {
+  // New id of every node of the component (-1 for the rest)
+  std::vector<int> new_id(g.n, -1);
+  original_ids.clear();
+  for (int u = 0; u < g.n; u++) {
+    if (g.component[u] == comp) {
+      new_id[u] = static_cast<int>(original_ids.size());
+      original_ids.push_back(u);
+    }
+  }
+
+  // Every arc leaving a node of the component stays only if it comes back
+  // into it
+  int n = static_cast<int>(original_ids.size());
+  int m = 0;
+  for (int u : original_ids) {
+    auto [begin, end] = g.neighbours(u);
+    for (auto it = begin; it != end; ++it)
+      m += (new_id[*it] != -1);
+  }
+
+  Graph sub(n, m);
+  int pos = 0;
+  for (int i = 0; i < n; i++) {
+    int u = original_ids[i];
+    sub.coords[i] = g.coords[u];
+    sub.row_ptr[i] = pos;
+
+    auto [begin, end] = g.neighbours(u);
+    int idx = g.row_ptr[u];
+    for (auto it = begin; it != end; ++it, ++idx) {
+      if (new_id[*it] == -1)
+        continue;
+      sub.col_idx[pos] = new_id[*it];
+      sub.weights[pos] = g.weights[idx];
+      pos++;
+    }
+  }
+  sub.row_ptr[n] = pos;
+
+  // A single component: every node shares it
+  sub.component.assign(n, 0);
+  sub.component_group.assign(1, 0);
+  return sub;
+}
+
+bool write_dimacs(const Graph &g, const std::string &dataset_name) {
+  std::ofstream gr(dataset_name + ".gr");
+  std::ofstream co(dataset_name + ".co");
+  if (!gr.is_open() || !co.is_open())
+    return false;
+
+  gr << "p sp " << g.n << " " << g.m << "\n";
+  for (int u = 0; u < g.n; u++) {
+    auto [begin, end] = g.neighbours(u);
+    int idx = g.row_ptr[u];
+    for (auto it = begin; it != end; ++it, ++idx)
+      gr << "a " << (u + 1) << " " << (*it + 1) << " " << g.weights[idx]
+         << "\n";
+  }
+
+  co << "p aux sp co " << g.n << "\n";
+  for (int u = 0; u < g.n; u++)
+    co << "v " << (u + 1) << " " << g.coords[u].lon << " " << g.coords[u].lat
+       << "\n";
+
+  return static_cast<bool>(gr) && static_cast<bool>(co);
+}
+
+} // namespace GraphComponents
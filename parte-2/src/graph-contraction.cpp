@@ -0,0 +1,294 @@
+#include "graph_contraction.hpp"
+#include <algorithm>
+#include <chrono>
+
+// Cheapest arc u -> v (the one a search would relax), -1 if none
+static int cheapest_arc(const Graph &g, int u, int v) {
+  int best = -1;
+  for (int e = g.row_ptr[u]; e < g.row_ptr[u + 1]; e++)
+    if (g.col_idx[e] == v && (best == -1 || g.weights[e] < g.weights[best]))
+      best = e;
+  return best;
+}
+
+ContractedGraph::ContractedGraph(const Graph &g)
+    : g_(g), core_id_(g.n, -1), slots_(2 * static_cast<std::size_t>(g.n),
+                                       Slot{-1, 0}) {
+  // 1. Distinct neighbours of every node (in or out), up to two of them.
+  // count 3 means "more than two" (or a self-loop): never contracted.
+  std::vector<int> nb(2 * static_cast<std::size_t>(g.n), -1);
+  std::vector<char> count(g.n, 0);
+  auto add = [&](int u, int v) {
+    if (u == v) {
+      count[u] = 3;
+      return;
+    }
+    if (count[u] == 3 || nb[2 * u] == v || nb[2 * u + 1] == v)
+      return;
+    if (count[u] < 2)
+      nb[2 * u + count[u]] = v;
+    count[u]++;
+  };
+  for (int u = 0; u < g.n; u++) {
+    auto [begin, end] = g.neighbours(u);
+    for (auto it = begin; it != end; ++it) {
+      add(u, *it);
+      add(*it, u);
+    }
+  }
+  // Only pure one-way (a -> v -> b) or two-way (a <-> v <-> b) nodes are
+  // contracted: a mixed node can be left towards a neighbour it cannot be
+  // reached from, which a chain arc could not represent
+  std::vector<char> core(g.n);
+  for (int u = 0; u < g.n; u++) {
+    core[u] = (count[u] != 2);
+    if (core[u])
+      continue;
+    int a = nb[2 * u], b = nb[2 * u + 1];
+    bool in_a = cheapest_arc(g, a, u) != -1;
+    bool out_a = cheapest_arc(g, u, a) != -1;
+    bool in_b = cheapest_arc(g, b, u) != -1;
+    bool out_b = cheapest_arc(g, u, b) != -1;
+    bool two_way = in_a && out_a && in_b && out_b;
+    bool one_way = (in_a && out_b && !out_a && !in_b) ||
+                   (in_b && out_a && !out_b && !in_a);
+    core[u] = !(two_way || one_way);
+  }
+
+  // 2. Chains: from every core node, follow each arc until the next core
+  // node. Neighbouring contracted nodes are of the same kind, so a chain
+  // only stops early (and is dropped) inside a cycle being promoted.
+  struct Chain {
+    int tail, head, weight;
+    std::vector<int> arcs;
+  };
+  std::vector<Chain> chains;
+  std::vector<char> visited(g.n, 0);
+  std::vector<int> seq;
+
+  auto walk_from = [&](int u) {
+    for (int e0 = g.row_ptr[u]; e0 < g.row_ptr[u + 1]; e0++) {
+      int v = g.col_idx[e0];
+      // Parallel arcs into a chain would duplicate it: keep the cheapest
+      if (!core[v] && e0 != cheapest_arc(g, u, v))
+        continue;
+
+      seq.assign(1, e0);
+      int weight = g.weights[e0];
+      int prev = u;
+      bool complete = true;
+      while (!core[v]) {
+        visited[v] = 1;
+        int next = (nb[2 * v] == prev) ? nb[2 * v + 1] : nb[2 * v];
+        int e = cheapest_arc(g, v, next);
+        if (e == -1) {
+          complete = false;
+          break;
+        }
+        seq.push_back(e);
+        weight += g.weights[e];
+        prev = v;
+        v = next;
+      }
+      if (complete)
+        chains.push_back({u, v, weight, seq});
+    }
+  };
+
+  for (int u = 0; u < g.n; u++)
+    if (core[u])
+      walk_from(u);
+
+  // Cycles made only of degree-2 nodes are never reached from the core:
+  // one node of each becomes a core node
+  for (int u = 0; u < g.n; u++) {
+    if (!core[u] && !visited[u]) {
+      core[u] = 1;
+      walk_from(u);
+    }
+  }
+
+  // 3. Core ids (original order) and core CSR
+  for (int u = 0; u < g.n; u++) {
+    if (core[u]) {
+      core_id_[u] = static_cast<int>(original_id_.size());
+      original_id_.push_back(u);
+    }
+  }
+  int n = static_cast<int>(original_id_.size());
+  int m = static_cast<int>(chains.size());
+  core_ = Graph(n, m);
+  for (int i = 0; i < n; i++)
+    core_.coords[i] = g.coords[original_id_[i]];
+
+  for (const Chain &c : chains)
+    core_.row_ptr[core_id_[c.tail] + 1]++;
+  for (int i = 0; i < n; i++)
+    core_.row_ptr[i + 1] += core_.row_ptr[i];
+
+  // Chains were generated grouped by tail, but promoted cycle nodes come
+  // after the rest: place every chain at its tail's next free slot
+  std::vector<int> next_pos(core_.row_ptr.begin(), core_.row_ptr.end() - 1);
+  std::vector<int> order(m);
+  for (int c = 0; c < m; c++)
+    order[next_pos[core_id_[chains[c].tail]]++] = c;
+
+  tail_.resize(m);
+  arcs_ptr_.assign(1, 0);
+  for (int e = 0; e < m; e++) {
+    const Chain &c = chains[order[e]];
+    core_.col_idx[e] = core_id_[c.head];
+    core_.weights[e] = c.weight;
+    tail_[e] = core_id_[c.tail];
+
+    // Every contracted node on the chain records where it is
+    for (std::size_t k = 0; k + 1 < c.arcs.size(); k++) {
+      int v = g.col_idx[c.arcs[k]];
+      Slot *slot = &slots_[2 * static_cast<std::size_t>(v)];
+      if (slot->arc != -1)
+        slot++;
+      *slot = {e, static_cast<int>(k)};
+    }
+    arcs_.insert(arcs_.end(), c.arcs.begin(), c.arcs.end());
+    arcs_ptr_.push_back(static_cast<int>(arcs_.size()));
+  }
+
+  // 4. Reachability is unchanged by the contraction
+  if (!g.component.empty()) {
+    core_.component.resize(n);
+    for (int i = 0; i < n; i++)
+      core_.component[i] = g.component[original_id_[i]];
+    core_.component_group = g.component_group;
+  }
+}
+
+int ContractedGraph::prefix(int e, int k) const {
+  int sum = 0;
+  for (int i = arcs_ptr_[e]; i < arcs_ptr_[e] + k; i++)
+    sum += g_.weights[arcs_[i]];
+  return sum;
+}
+
+void ContractedGraph::expand(int e, int from, int to, std::vector<int> &path,
+                             std::vector<int> &arcs) const {
+  for (int i = arcs_ptr_[e] + from; i < arcs_ptr_[e] + to; i++) {
+    arcs.push_back(arcs_[i]);
+    path.push_back(g_.col_idx[arcs_[i]]);
+  }
+}
+
+AlgorithmResult ContractedGraph::route(Algorithm &solver, int s,
+                                       int t) const {
+  auto start_time = std::chrono::high_resolution_clock::now();
+  auto length = [&](int e) { return arcs_ptr_[e + 1] - arcs_ptr_[e]; };
+  const Slot *s_slots = &slots_[2 * static_cast<std::size_t>(s)];
+  const Slot *t_slots = &slots_[2 * static_cast<std::size_t>(t)];
+
+  if (s == t)
+    return AlgorithmResult{{s}, 0, 0, 0};
+
+  // 1. Core entry points: a contracted source leaves its chain(s) forwards,
+  // a contracted target is entered from the start of its chain(s)
+  std::vector<int> sources, source_offsets, targets, target_offsets;
+  if (core_id_[s] != -1) {
+    sources.push_back(core_id_[s]);
+    source_offsets.push_back(0);
+  } else {
+    for (int i = 0; i < 2; i++) {
+      const Slot &sl = s_slots[i];
+      if (sl.arc == -1)
+        continue;
+      sources.push_back(core_.col_idx[sl.arc]);
+      source_offsets.push_back(prefix(sl.arc, length(sl.arc)) -
+                               prefix(sl.arc, sl.pos + 1));
+    }
+  }
+  if (core_id_[t] != -1) {
+    targets.push_back(core_id_[t]);
+    target_offsets.push_back(0);
+  } else {
+    for (int i = 0; i < 2; i++) {
+      const Slot &sl = t_slots[i];
+      if (sl.arc == -1)
+        continue;
+      targets.push_back(tail_[sl.arc]);
+      target_offsets.push_back(prefix(sl.arc, sl.pos + 1));
+    }
+  }
+
+  AlgorithmResult result{{}, static_cast<double>(Algorithm::INF_INT), 0, 0};
+  if (!sources.empty() && !targets.empty())
+    result =
+        solver.run_multi(sources, source_offsets, targets, target_offsets);
+
+  // 2. Both endpoints on the same chain, in order: no core node in between
+  int direct_arc = -1, direct_from = 0, direct_to = 0;
+  int direct_cost = Algorithm::INF_INT;
+  if (core_id_[s] == -1 && core_id_[t] == -1) {
+    for (int i = 0; i < 2; i++) {
+      for (int j = 0; j < 2; j++) {
+        const Slot &a = s_slots[i], &b = t_slots[j];
+        if (a.arc == -1 || a.arc != b.arc || a.pos >= b.pos)
+          continue;
+        int cost = prefix(a.arc, b.pos + 1) - prefix(a.arc, a.pos + 1);
+        if (cost < direct_cost) {
+          direct_cost = cost;
+          direct_arc = a.arc;
+          direct_from = a.pos + 1;
+          direct_to = b.pos + 1;
+        }
+      }
+    }
+  }
+
+  // 3. Expansion back to original ids and arcs
+  std::vector<int> path{s};
+  std::vector<int> arcs;
+  if (direct_arc != -1 && direct_cost <= result.cost) {
+    expand(direct_arc, direct_from, direct_to, path, arcs);
+    result.cost = direct_cost;
+  } else if (!result.path.empty()) {
+    // Chain (or chain direction) that produced the winning source / target
+    auto pick = [&](const Slot *slots, bool head, int core_node, bool leave) {
+      const Slot *best = nullptr;
+      int best_cost = Algorithm::INF_INT;
+      for (int i = 0; i < 2; i++) {
+        const Slot &sl = slots[i];
+        if (sl.arc == -1)
+          continue;
+        int end = head ? core_.col_idx[sl.arc] : tail_[sl.arc];
+        int cost = leave ? prefix(sl.arc, length(sl.arc)) -
+                               prefix(sl.arc, sl.pos + 1)
+                         : prefix(sl.arc, sl.pos + 1);
+        if (end == core_node && cost < best_cost) {
+          best = &sl;
+          best_cost = cost;
+        }
+      }
+      return best;
+    };
+
+    if (core_id_[s] == -1) {
+      const Slot *sl = pick(s_slots, true, result.source, true);
+      expand(sl->arc, sl->pos + 1, length(sl->arc), path, arcs);
+    }
+    for (int e : result.arcs)
+      expand(e, 0, length(e), path, arcs);
+    if (core_id_[t] == -1) {
+      const Slot *sl = pick(t_slots, false, result.target, false);
+      expand(sl->arc, 0, sl->pos + 1, path, arcs);
+    }
+  } else {
+    path.clear();
+  }
+
+  auto end_time = std::chrono::high_resolution_clock::now();
+  result.path = std::move(path);
+  result.arcs = std::move(arcs);
+  result.source = result.path.empty() ? -1 : s;
+  result.target = result.path.empty() ? -1 : t;
+  result.ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time -
+                                                                    start_time)
+                  .count();
+  return result;
+}
@@ -194,7 +194,7 @@ Graph GraphParser::parse() {
   }
 
   // Create temp_ptr
-  std::vector<int> temp_ptr = g.row_ptr;
+  std::vector<int> temp_ptr(g.row_ptr.begin(), g.row_ptr.end());
 
   // Insert edges into CSR
   for (const auto &e : edges) {
@@ -1,40 +1,107 @@
 #include "algorithm.hpp"
+#include "graph_components.hpp"
+#include "graph_contraction.hpp"
 #include "graph_parser.hpp"
 #include "logger.hpp"
+#include "path_writer.hpp"
+#include "perf_counter.hpp"
+#include "spatial_index.hpp"
+#include <chrono>
+#include <cmath>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
 
-static int edge_cost(const Graph &g, int u, int v) {
-  auto [begin, end] = g.neighbours(u);
-  for (auto it = begin; it != end; ++it) {
-    if (*it == v) {
-      int edge_idx = (it - begin) + g.row_ptr[u];
-      return g.weights[edge_idx];
+// Parses "lat,lon" in degrees into microdegrees. Returns false for node ids.
+static bool parse_point(const std::string &arg, Coord &c) {
+  auto comma = arg.find(',');
+  if (comma == std::string::npos)
+    return false;
+  double lat = std::stod(arg.substr(0, comma));
+  double lon = std::stod(arg.substr(comma + 1));
+  c = {static_cast<int>(std::lround(lon * 1000000.0)),
+       static_cast<int>(std::lround(lat * 1000000.0))};
+  return true;
+}
+
+// Reads one node per line: "<id> [offset]" (1-based ids, offset >= 0 in
+// the units of the arc weights). Returns false if the file cannot be read
+// or an offset is negative.
+static bool read_node_list(const std::string &filename, std::vector<int> &ids,
+                           std::vector<int> &offsets) {
+  std::ifstream fin(filename);
+  if (!fin.is_open())
+    return false;
+  std::string line;
+  while (std::getline(fin, line)) {
+    std::istringstream ss(line);
+    int id, offset = 0;
+    if (!(ss >> id))
+      continue;
+    ss >> offset;
+    if (offset < 0) {
+      Logger::error("Coste negativo en " + filename + ": " + line);
+      return false;
     }
+    ids.push_back(id - 1);
+    offsets.push_back(offset);
   }
-  return -1;
+  return true;
 }
 
-enum class AlgorithmMode { ASTAR, DIJKSTRA, BOTH };
+enum class AlgorithmMode {
+  ASTAR,
+  DIJKSTRA,
+  BOTH,
+  WASTAR,
+  ANYTIME,
+  ALTERNATIVES,
+  PARALLEL
+};
 
 int main(int argc, char **argv) {
 
   /* =======================
    * Argument parsing
    * ======================= */
-  if (argc != 5 && argc != 7) {
+  if (argc < 5 || (argc - 5) % 2 != 0) {
     Logger::error("Argumentos incorrectos.");
     std::cout << "Uso:\n"
               << "  " << argv[0]
               << " <v_inicio> <v_fin> <mapa> <fichero_salida>\n"
+              << "  (los vértices también pueden darse como <lat,lon> en "
+                 "grados)\n"
               << "Opcional:\n"
-              << "  --algorithm <astar | dijkstra | both>\n";
+              << "  --algorithm <astar | dijkstra | both | wastar | anytime |"
+                 " alternatives | parallel>\n"
+              << "  --weight <w>        (wastar/anytime, por defecto 1.5)\n"
+              << "  --deadline <ms>     (anytime, por defecto 100)\n"
+              << "  --alternatives <k>  (alternatives, por defecto 2)\n"
+              << "  --threads <n>       (parallel, por defecto todos los "
+                 "núcleos)\n"
+              << "  --format <text | binary>  (fichero de salida, por defecto "
+                 "text)\n"
+              << "  --hugepages <off | thp | explicit>  (por defecto thp; "
+                 "informa de los fallos de TLB)\n"
+              << "  --sources <fichero>  (un vértice por línea, \"id [coste "
+                 "inicial]\"; sustituye a v_inicio)\n"
+              << "  --targets <fichero>  (un vértice por línea, \"id [coste "
+                 "final]\"; sustituye a v_fin)\n"
+              << "  --contract <on | off>  (astar: busca sobre el grafo con "
+                 "las cadenas de grado 2 contraídas, por defecto off)\n"
+              << "  --extract-largest <nombre>  (guarda la mayor componente "
+                 "fuertemente conexa como <nombre>.gr/.co)\n";
     return 1;
   }
 
-  // Parse nodes
-  int start_node = std::stoi(argv[1]) - 1; // 0-based
-  int goal_node = std::stoi(argv[2]) - 1;
+  // Parse nodes (ids or coordinates, snapped once the graph is loaded)
+  Coord start_point{}, goal_point{};
+  const bool start_is_point = parse_point(argv[1], start_point);
+  const bool goal_is_point = parse_point(argv[2], goal_point);
+  int start_node = start_is_point ? 0 : std::stoi(argv[1]) - 1; // 0-based
+  int goal_node = goal_is_point ? 0 : std::stoi(argv[2]) - 1;
 
   // Node verification
   if (start_node < 0 || goal_node < 0) {
@@ -48,30 +115,136 @@ int main(int argc, char **argv) {
   // Default algorithm
   AlgorithmMode mode = AlgorithmMode::ASTAR;
 
-  // If algorithm was specified:
-  if (argc == 7) {
-    if (std::string(argv[5]) != "--algorithm") {
-      Logger::error("Opción desconocida: " + std::string(argv[5]));
-      return 1;
-    }
+  // Weighted A* parameters
+  double weight = 1.5;
+  long long deadline_ms = 100;
+
+  // Number of alternative routes
+  int n_alternatives = 2;
+
+  // Workers of the parallel search
+  unsigned n_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  // Output file format
+  PathWriter::Format format = PathWriter::Format::TEXT;
 
-    // Parse algorithm
-    std::string value = argv[6];
-    if (value == "astar")
-      mode = AlgorithmMode::ASTAR;
-    else if (value == "dijkstra")
-      mode = AlgorithmMode::DIJKSTRA;
-    else if (value == "both")
-      mode = AlgorithmMode::BOTH;
-    else {
-      Logger::error("Algoritmo desconocido: " + value);
+  // Huge page policy; TLB misses are reported when it is given explicitly
+  bool report_tlb = false;
+
+  // Source / target sets (optional, override the positional nodes)
+  std::string sources_file, targets_file;
+
+  // Degree-2 chain contraction before searching (A* only)
+  bool contract = false;
+
+  // Output name for the largest strongly connected component (optional)
+  std::string extract_name;
+
+  // Optional arguments (pairs: --option value)
+  for (int i = 5; i < argc; i += 2) {
+    std::string option = argv[i];
+    std::string value = argv[i + 1];
+
+    if (option == "--algorithm") {
+      if (value == "astar")
+        mode = AlgorithmMode::ASTAR;
+      else if (value == "dijkstra")
+        mode = AlgorithmMode::DIJKSTRA;
+      else if (value == "both")
+        mode = AlgorithmMode::BOTH;
+      else if (value == "wastar")
+        mode = AlgorithmMode::WASTAR;
+      else if (value == "anytime")
+        mode = AlgorithmMode::ANYTIME;
+      else if (value == "alternatives")
+        mode = AlgorithmMode::ALTERNATIVES;
+      else if (value == "parallel")
+        mode = AlgorithmMode::PARALLEL;
+      else {
+        Logger::error("Algoritmo desconocido: " + value);
+        return 1;
+      }
+    } else if (option == "--weight") {
+      weight = std::stod(value);
+      if (weight < 1.0) {
+        Logger::error("El peso debe ser >= 1.");
+        return 1;
+      }
+    } else if (option == "--deadline") {
+      deadline_ms = std::stoll(value);
+    } else if (option == "--alternatives") {
+      n_alternatives = std::stoi(value);
+    } else if (option == "--threads") {
+      int t = std::stoi(value);
+      if (t < 1) {
+        Logger::error("El número de hilos debe ser >= 1.");
+        return 1;
+      }
+      n_threads = static_cast<unsigned>(t);
+    } else if (option == "--format") {
+      if (value == "text")
+        format = PathWriter::Format::TEXT;
+      else if (value == "binary")
+        format = PathWriter::Format::BINARY;
+      else {
+        Logger::error("Formato desconocido: " + value);
+        return 1;
+      }
+    } else if (option == "--hugepages") {
+      if (value == "off")
+        HugePages::mode() = HugePageMode::OFF;
+      else if (value == "thp")
+        HugePages::mode() = HugePageMode::TRANSPARENT;
+      else if (value == "explicit")
+        HugePages::mode() = HugePageMode::EXPLICIT;
+      else {
+        Logger::error("Modo de huge pages desconocido: " + value);
+        return 1;
+      }
+      report_tlb = true;
+    } else if (option == "--sources") {
+      sources_file = value;
+    } else if (option == "--targets") {
+      targets_file = value;
+    } else if (option == "--contract") {
+      if (value == "on")
+        contract = true;
+      else if (value == "off")
+        contract = false;
+      else {
+        Logger::error("Valor de --contract desconocido: " + value);
+        return 1;
+      }
+    } else if (option == "--extract-largest") {
+      extract_name = value;
+    } else {
+      Logger::error("Opción desconocida: " + option);
       return 1;
     }
   }
 
+  // Many sources/targets: one search seeded with every source
+  const bool run_multi = !sources_file.empty() || !targets_file.empty();
+  if (run_multi && mode != AlgorithmMode::ASTAR) {
+    Logger::error("--sources/--targets solo admiten --algorithm astar.");
+    return 1;
+  }
+
+  // More workers than cores: every message waits for a context switch and
+  // the workers expand many nodes with non-final g
+  if (mode == AlgorithmMode::PARALLEL &&
+      n_threads > std::thread::hardware_concurrency())
+    Logger::info("Hay más hilos (" + std::to_string(n_threads) +
+                 ") que núcleos: el A* paralelo será más lento.");
+
   // Conditionals for running algorithms
-  const bool run_astar = (mode != AlgorithmMode::DIJKSTRA);
-  const bool run_dijkstra = (mode != AlgorithmMode::ASTAR);
+  const bool run_astar =
+      !run_multi &&
+      (mode == AlgorithmMode::ASTAR || mode == AlgorithmMode::BOTH);
+  const bool run_dijkstra =
+      (mode == AlgorithmMode::DIJKSTRA || mode == AlgorithmMode::BOTH);
+  const bool run_weighted =
+      (mode == AlgorithmMode::WASTAR || mode == AlgorithmMode::ANYTIME);
 
   Logger::print_header();
 
@@ -97,36 +270,192 @@ int main(int argc, char **argv) {
     return 1;
   }
 
+  /* =======================
+   * Coordinate snapping
+   * ======================= */
+  if (start_is_point || goal_is_point) {
+    auto t0 = std::chrono::high_resolution_clock::now();
+    SpatialIndex index(g);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    if (start_is_point)
+      start_node = index.nearest(start_point);
+    if (goal_is_point)
+      goal_node = index.nearest(goal_point);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    auto build_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+    auto snap_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+    Logger::info("Índice espacial en " + Logger::fmt_int(build_ms) +
+                 " ms, ajuste en " + Logger::fmt_int(snap_us) + " us: " +
+                 std::to_string(start_node + 1) + " -> " +
+                 std::to_string(goal_node + 1));
+  }
+
+  std::vector<int> sources{start_node}, source_offsets{0};
+  std::vector<int> targets{goal_node}, target_offsets;
+  if (!sources_file.empty()) {
+    sources.clear();
+    source_offsets.clear();
+    if (!read_node_list(sources_file, sources, source_offsets) ||
+        sources.empty()) {
+      Logger::error("No se pudieron leer los orígenes: " + sources_file);
+      return 1;
+    }
+  }
+  if (!targets_file.empty()) {
+    targets.clear();
+    if (!read_node_list(targets_file, targets, target_offsets) ||
+        targets.empty()) {
+      Logger::error("No se pudieron leer los destinos: " + targets_file);
+      return 1;
+    }
+  }
+  for (int v : sources)
+    if (v < 0 || v >= n_nodes) {
+      Logger::error("Origen fuera de rango: " + std::to_string(v + 1));
+      return 1;
+    }
+  for (int v : targets)
+    if (v < 0 || v >= n_nodes) {
+      Logger::error("Destino fuera de rango: " + std::to_string(v + 1));
+      return 1;
+    }
+
+  /* =======================
+   * Component index
+   * ======================= */
+  GraphComponents::load_or_compute(g, map_name + ".scc");
+
+  if (!extract_name.empty()) {
+    std::vector<int> original_ids;
+    Graph sub = GraphComponents::extract(g, GraphComponents::largest(g),
+                                         original_ids);
+    if (!GraphComponents::write_dimacs(sub, extract_name)) {
+      Logger::error("No se pudo escribir la componente: " + extract_name);
+      return 1;
+    }
+    Logger::info("Mayor componente guardada en " + extract_name + " (" +
+                 Logger::fmt_int(sub.n) + " vértices, " +
+                 Logger::fmt_int(sub.m) + " arcos)");
+  }
+
   /* =======================
    * Run algorithms
    * ======================= */
   Algorithm solver(g, start_node, goal_node);
 
+  // Contracted graph and its own workspace (only with --contract on)
+  std::unique_ptr<ContractedGraph> contracted;
+  std::unique_ptr<Algorithm> core_solver;
+  if (contract && mode == AlgorithmMode::ASTAR && !run_multi) {
+    auto t0 = std::chrono::high_resolution_clock::now();
+    contracted = std::make_unique<ContractedGraph>(g);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    const Graph &core = contracted->core();
+    core_solver = std::make_unique<Algorithm>(core, 0, 0);
+    Logger::info(
+        "Contracción de cadenas en " +
+        Logger::fmt_int(
+            std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0)
+                .count()) +
+        " ms: " + Logger::fmt_int(g.n) + " -> " + Logger::fmt_int(core.n) +
+        " vértices, " + Logger::fmt_int(g.m) + " -> " +
+        Logger::fmt_int(core.m) + " arcos");
+  } else if (contract) {
+    Logger::info("--contract solo se aplica a --algorithm astar.");
+  }
+
   AlgorithmResult astar_result{};
   AlgorithmResult dijkstra_result{};
+  AlgorithmResult weighted_result{};
+  AlgorithmResult alternatives_result{};
+  AlgorithmResult multi_result{};
+  AlgorithmResult parallel_result{};
+
+  TlbMissCounter tlb;
+  tlb.start();
 
   // Run algorithms if specified
   if (run_astar)
-    astar_result = solver.run();
+    astar_result = contracted
+                       ? contracted->route(*core_solver, start_node, goal_node)
+                       : solver.run();
+
+  if (run_multi)
+    multi_result =
+        solver.run_multi(sources, source_offsets, targets, target_offsets);
 
   if (run_dijkstra)
     dijkstra_result = solver.run_dijkstra();
 
+  if (mode == AlgorithmMode::WASTAR)
+    weighted_result = solver.run_weighted(weight);
+  else if (mode == AlgorithmMode::ANYTIME)
+    weighted_result = solver.run_anytime(weight, deadline_ms);
+
+  if (mode == AlgorithmMode::ALTERNATIVES) {
+    Graph reverse = g.transposed();
+    alternatives_result = solver.run_alternatives(reverse, n_alternatives);
+  }
+
+  if (mode == AlgorithmMode::PARALLEL)
+    parallel_result = solver.run_parallel(n_threads);
+
+  long long tlb_misses = tlb.stop();
+
   // Print results
   if (run_astar) {
     Logger::print_alg_stats("A*", astar_result.ms, astar_result.expansions,
                             astar_result.cost);
   }
+  if (run_multi) {
+    Logger::print_alg_stats("A* multi", multi_result.ms,
+                            multi_result.expansions, multi_result.cost);
+    if (!multi_result.path.empty())
+      Logger::info("Par ganador (" + Logger::fmt_int(sources.size()) +
+                   " orígenes, " + Logger::fmt_int(targets.size()) +
+                   " destinos): " + std::to_string(multi_result.source + 1) +
+                   " -> " + std::to_string(multi_result.target + 1));
+  }
   if (run_dijkstra) {
     Logger::print_alg_stats("Dijkstra", dijkstra_result.ms,
                             dijkstra_result.expansions, dijkstra_result.cost);
   }
+  if (run_weighted) {
+    std::string name =
+        (mode == AlgorithmMode::WASTAR) ? "A* ponderado" : "A* anytime";
+    Logger::print_alg_stats(name, weighted_result.ms,
+                            weighted_result.expansions, weighted_result.cost);
+    Logger::print_bound(weighted_result.bound);
+  }
+  if (mode == AlgorithmMode::ALTERNATIVES) {
+    Logger::print_alg_stats("Alternativas", alternatives_result.ms,
+                            alternatives_result.expansions,
+                            alternatives_result.cost);
+    for (const auto &alt : alternatives_result.alternatives)
+      Logger::print_alternative(alt.cost, alternatives_result.cost);
+  }
+  if (mode == AlgorithmMode::PARALLEL) {
+    Logger::print_alg_stats("A* paralelo (" + std::to_string(n_threads) +
+                                " hilos)",
+                            parallel_result.ms, parallel_result.expansions,
+                            parallel_result.cost);
+  }
+  if (report_tlb)
+    Logger::print_tlb(tlb_misses);
   if (mode == AlgorithmMode::BOTH) {
     Logger::print_comparison(astar_result.cost, dijkstra_result.cost);
   }
 
   const auto &result_to_write =
-      (mode == AlgorithmMode::DIJKSTRA) ? dijkstra_result : astar_result;
+      run_weighted                            ? weighted_result
+      : (mode == AlgorithmMode::ALTERNATIVES) ? alternatives_result
+      : run_multi                             ? multi_result
+      : (mode == AlgorithmMode::PARALLEL)     ? parallel_result
+      : (mode == AlgorithmMode::DIJKSTRA)     ? dijkstra_result
+                                              : astar_result;
   if (result_to_write.path.empty()) {
     Logger::info("No se ha encontrado camino entre " +
                  std::to_string(start_node + 1) + " y " +
@@ -137,22 +466,21 @@ int main(int argc, char **argv) {
   /* =======================
    * Output (file)
    * ======================= */
-  std::ofstream fout(output_filename);
-  if (!fout) {
+  PathWriter writer(format);
+  if (!writer.open(output_filename)) {
     Logger::error("No se pudo abrir el fichero de salida: " + output_filename);
     return 1;
   }
 
-  for (size_t i = 0; i < result_to_write.path.size(); ++i) {
-    int u = result_to_write.path[i];
-    fout << (u + 1);
+  // One route per line: the optimal one first, then the alternatives
+  writer.write(g, result_to_write.path, result_to_write.arcs);
+  for (const auto &alt : result_to_write.alternatives)
+    writer.write(g, alt.path);
 
-    if (i + 1 < result_to_write.path.size()) {
-      int v = result_to_write.path[i + 1];
-      fout << " - (" << edge_cost(g, u, v) << ") - ";
-    }
+  if (!writer.close()) {
+    Logger::error("Error al escribir el fichero de salida: " +
+                  output_filename);
+    return 1;
   }
-
-  fout << "\n";
   return 0;
 }
@@ -0,0 +1,74 @@
+#include "numa_topology.hpp"
+#include <algorithm>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace Numa {
+
+// Parses a sysfs CPU list such as "0-3,8-11"
+static std::vector<int> parse_cpulist(const std::string &list) {
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty() || range == "\n")
+      continue;
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = (dash == std::string::npos) ? first
+                                           : std::stoi(range.substr(dash + 1));
+    for (int c = first; c <= last; c++)
+      cpus.push_back(c);
+  }
+  return cpus;
+}
+
+std::vector<Node> detect() {
+  std::vector<Node> nodes;
+  for (int id = 0;; id++) {
+    std::ifstream fin("/sys/devices/system/node/node" + std::to_string(id) +
+                      "/cpulist");
+    if (!fin.is_open())
+      break;
+    std::string list;
+    std::getline(fin, list);
+    std::vector<int> cpus = parse_cpulist(list);
+    // Memory-only nodes cannot run workers
+    if (!cpus.empty())
+      nodes.push_back({id, std::move(cpus)});
+  }
+
+  if (nodes.empty()) {
+    Node all{0, {}};
+    unsigned n = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned c = 0; c < n; c++)
+      all.cpus.push_back(static_cast<int>(c));
+    nodes.push_back(std::move(all));
+  }
+  return nodes;
+}
+
+bool pin_current_thread(const std::vector<int> &cpus) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int c : cpus)
+    if (c >= 0 && c < CPU_SETSIZE)
+      CPU_SET(c, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+std::unique_ptr<Graph> replicate(const Graph &g, const Node &node) {
+  std::unique_ptr<Graph> replica;
+  std::thread worker([&] {
+    pin_current_thread(node.cpus);
+    replica = std::make_unique<Graph>(g);
+  });
+  worker.join();
+  return replica;
+}
+
+} // namespace Numa
@@ -0,0 +1,245 @@
+#include "algorithm.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+/***
+ * HASH-DISTRIBUTED A* (HDA*)
+ *
+ * Every node is owned by one worker (hash of its id). Only the owner reads
+ * or writes g_, parent_, parent_arc_ and closed_ for that node and keeps it
+ * in its own OpenList, so the shared arrays need no locks. A worker that
+ * generates a node owned by another one sends it (g, parent, arc) through
+ * the owner's lock-free inbox, in batches.
+ *
+ * Termination: `work` counts busy workers plus batches in flight. A sender
+ * increments it before publishing a batch and the receiver decrements it
+ * once the batch is in its OpenList; a worker going idle decrements it and
+ * increments it again before taking new batches. Therefore work > 0 while
+ * any node can still be expanded, and work == 0 means every worker is idle
+ * with no message pending.
+ *
+ * Optimality: nodes with f >= incumbent are discarded. When work reaches 0
+ * every node with f below the incumbent has been expanded with its final
+ * g, so (h being admissible) the incumbent is the optimal cost.
+ */
+
+namespace {
+
+// Nodes sent per batch and expansions between forced flushes: larger
+// batches mean fewer atomics, smaller ones keep idle workers fed
+const int BATCH_SIZE = 64;
+const int FLUSH_INTERVAL = 8;
+
+struct Message {
+  int node;
+  int g;
+  int parent;
+  int arc;
+};
+
+struct Batch {
+  Batch *next = nullptr;
+  int count = 0;
+  Message msgs[BATCH_SIZE];
+};
+
+// Multi-producer single-consumer stack of batches (Treiber push, the
+// consumer takes the whole list at once)
+class alignas(64) Inbox {
+public:
+  void push(Batch *b) {
+    b->next = head_.load(std::memory_order_relaxed);
+    while (!head_.compare_exchange_weak(b->next, b, std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+    }
+  }
+
+  Batch *take() { return head_.exchange(nullptr, std::memory_order_acquire); }
+
+  bool empty() const {
+    return head_.load(std::memory_order_relaxed) == nullptr;
+  }
+
+private:
+  std::atomic<Batch *> head_{nullptr};
+};
+
+// Multiplicative hash: spreads consecutive ids (usually close on the map)
+// over every worker so the frontier is balanced
+inline int owner(int v, int threads) {
+  return static_cast<int>(
+      ((static_cast<std::uint32_t>(v) * 2654435761u) >> 8) % threads);
+}
+
+} // namespace
+
+AlgorithmResult Algorithm::run_parallel(unsigned threads) {
+  auto start_time = std::chrono::high_resolution_clock::now();
+
+  if (!graph_.maybe_reachable(start_, goal_))
+    return AlgorithmResult{{}, static_cast<double>(INF_INT), 0, 0};
+
+  const int n_threads = static_cast<int>(threads < 1 ? 1 : threads);
+
+  double lat_rad = (graph_.coords[goal_].lat / 1000000.0) * (M_PI / 180.0);
+  double cos_lat_goal = std::cos(lat_rad);
+
+  // Reset data structures
+  std::fill(g_.begin(), g_.end(), INF_INT);
+  std::fill(parent_.begin(), parent_.end(), -1);
+  std::fill(parent_arc_.begin(), parent_arc_.end(), -1);
+  std::fill(closed_.begin(), closed_.end(), 0);
+
+  if (parallel_open_.size() < static_cast<std::size_t>(n_threads))
+    parallel_open_.resize(n_threads);
+  for (int t = 0; t < n_threads; t++)
+    parallel_open_[t].clear();
+
+  std::vector<Inbox> inboxes(n_threads);
+  std::vector<std::size_t> expansions(n_threads, 0);
+  std::atomic<int> incumbent{INF_INT};
+  std::atomic<int> work{n_threads};
+
+  auto worker = [&](int id) {
+    OpenList &open = parallel_open_[id];
+    std::vector<Batch *> outbox(n_threads, nullptr);
+    std::size_t local_expansions = 0;
+
+    // Owner-side relaxation
+    auto relax = [&](int v, int g, int parent, int arc) {
+      if (g >= g_[v])
+        return;
+      g_[v] = g;
+      parent_[v] = parent;
+      parent_arc_[v] = arc;
+
+      if (v == goal_) {
+        int best = incumbent.load(std::memory_order_relaxed);
+        while (g < best && !incumbent.compare_exchange_weak(
+                               best, g, std::memory_order_relaxed)) {
+        }
+        return;
+      }
+
+      int f = g + h(v, cos_lat_goal);
+      if (f >= incumbent.load(std::memory_order_relaxed))
+        return;
+      closed_[v] = 0; // reopened if it was expanded with a worse g
+      open.push(v, f);
+    };
+
+    auto flush = [&](int dest) {
+      work.fetch_add(1, std::memory_order_relaxed);
+      inboxes[dest].push(outbox[dest]);
+      outbox[dest] = nullptr;
+    };
+
+    auto flush_all = [&] {
+      for (int t = 0; t < n_threads; t++)
+        if (outbox[t] != nullptr)
+          flush(t);
+    };
+
+    auto drain = [&] {
+      Batch *b = inboxes[id].take();
+      while (b != nullptr) {
+        for (int i = 0; i < b->count; i++)
+          relax(b->msgs[i].node, b->msgs[i].g, b->msgs[i].parent,
+                b->msgs[i].arc);
+        Batch *next = b->next;
+        delete b;
+        b = next;
+        work.fetch_sub(1, std::memory_order_acq_rel);
+      }
+    };
+
+    if (owner(start_, n_threads) == id)
+      relax(start_, 0, -1, -1);
+
+    while (true) {
+      drain();
+
+      // Expand a few nodes between flushes
+      int expanded = 0;
+      while (expanded < FLUSH_INTERVAL && !open.empty()) {
+        int u = open.pop();
+        if (closed_[u])
+          continue;
+
+        int gu = g_[u];
+        if (gu + h(u, cos_lat_goal) >=
+            incumbent.load(std::memory_order_relaxed)) {
+          // Popped in f order: nothing left here can improve the incumbent
+          open.clear();
+          break;
+        }
+
+        closed_[u] = 1;
+        local_expansions++;
+        expanded++;
+
+        int idx = graph_.row_ptr[u];
+        auto [begin, end] = graph_.neighbours(u);
+        for (auto it = begin; it != end; ++it, ++idx) {
+          int v = *it;
+          int new_g = gu + graph_.weights[idx];
+          int dest = owner(v, n_threads);
+
+          if (dest == id) {
+            relax(v, new_g, u, idx);
+            continue;
+          }
+          if (outbox[dest] == nullptr)
+            outbox[dest] = new Batch();
+          outbox[dest]->msgs[outbox[dest]->count++] = {v, new_g, u, idx};
+          if (outbox[dest]->count == BATCH_SIZE)
+            flush(dest);
+        }
+      }
+      flush_all();
+
+      if (!open.empty() || !inboxes[id].empty())
+        continue;
+
+      // Idle: wait for messages or for global termination
+      work.fetch_sub(1, std::memory_order_acq_rel);
+      while (inboxes[id].empty()) {
+        if (work.load(std::memory_order_acquire) == 0) {
+          expansions[id] = local_expansions;
+          return;
+        }
+        std::this_thread::yield();
+      }
+      work.fetch_add(1, std::memory_order_acq_rel);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (int t = 1; t < n_threads; t++)
+    pool.emplace_back(worker, t);
+  worker(0);
+  for (auto &th : pool)
+    th.join();
+
+  std::vector<int> path;
+  std::vector<int> arcs;
+  int total_cost = incumbent.load();
+  if (total_cost != INF_INT)
+    reconstruct_path(goal_, path, arcs);
+
+  std::size_t total_expansions = 0;
+  for (std::size_t e : expansions)
+    total_expansions += e;
+
+  auto end_time = std::chrono::high_resolution_clock::now();
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time -
+                                                                  start_time)
+                .count();
+  AlgorithmResult result{path, static_cast<double>(total_cost),
+                         total_expansions, ms};
+  result.arcs = std::move(arcs);
+  return result;
+}
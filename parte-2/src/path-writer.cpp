@@ -0,0 +1,118 @@
+#include "path_writer.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Longest token: separator " - (" + 10 digits + ") - " + 10 digits
+const std::size_t MAX_TOKEN = 32;
+
+static const char BINARY_MAGIC[4] = {'P', 'F', 'B', '1'};
+
+// Weight of the cheapest arc u -> v (the one a search relaxes), -1 if none
+static int arc_weight(const Graph &g, int u, int v) {
+  int w = -1;
+  for (int e = g.row_ptr[u]; e < g.row_ptr[u + 1]; e++)
+    if (g.col_idx[e] == v && (w == -1 || g.weights[e] < w))
+      w = g.weights[e];
+  return w;
+}
+
+PathWriter::PathWriter(Format format, std::size_t capacity)
+    : format_(format), buffer_(capacity < MAX_TOKEN ? MAX_TOKEN : capacity) {}
+
+PathWriter::~PathWriter() { close(); }
+
+bool PathWriter::open(const std::string &filename) {
+  close();
+  out_ = std::fopen(filename.c_str(), "wb");
+  ok_ = (out_ != nullptr);
+  size_ = 0;
+  return ok_;
+}
+
+void PathWriter::flush() {
+  if (out_ != nullptr && size_ > 0 &&
+      std::fwrite(buffer_.data(), 1, size_, out_) != size_)
+    ok_ = false;
+  size_ = 0;
+}
+
+bool PathWriter::close() {
+  if (out_ == nullptr)
+    return ok_;
+  flush();
+  if (std::fclose(out_) != 0)
+    ok_ = false;
+  out_ = nullptr;
+  return ok_;
+}
+
+void PathWriter::put(const char *s, std::size_t n) {
+  // Large raw blocks (binary routes) may not fit the remaining buffer
+  while (n > 0) {
+    if (size_ == buffer_.size())
+      flush();
+    std::size_t chunk = std::min(n, buffer_.size() - size_);
+    std::memcpy(buffer_.data() + size_, s, chunk);
+    size_ += chunk;
+    s += chunk;
+    n -= chunk;
+  }
+}
+
+void PathWriter::put_uint(unsigned x) {
+  // Digits are produced backwards into a small scratch buffer
+  char digits[10];
+  int n = 0;
+  do {
+    digits[n++] = static_cast<char>('0' + x % 10);
+    x /= 10;
+  } while (x != 0);
+  while (n > 0)
+    buffer_[size_++] = digits[--n];
+}
+
+void PathWriter::write(const Graph &g, const std::vector<int> &path,
+                       const std::vector<int> &arcs) {
+  const bool have_arcs = (arcs.size() + 1 == path.size());
+  auto weight = [&](std::size_t i) {
+    return have_arcs ? g.weights[arcs[i]] : arc_weight(g, path[i], path[i + 1]);
+  };
+
+  if (format_ == Format::BINARY) {
+    std::uint32_t count = static_cast<std::uint32_t>(path.size());
+    reserve(sizeof(BINARY_MAGIC) + sizeof(count));
+    put_raw(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    put_raw(&count, sizeof(count));
+    for (int u : path) {
+      std::uint32_t id = static_cast<std::uint32_t>(u) + 1;
+      reserve(sizeof(id));
+      put_raw(&id, sizeof(id));
+    }
+    for (std::size_t i = 0; i + 1 < path.size(); i++) {
+      std::int32_t w = weight(i);
+      reserve(sizeof(w));
+      put_raw(&w, sizeof(w));
+    }
+    return;
+  }
+
+  for (std::size_t i = 0; i < path.size(); i++) {
+    reserve(MAX_TOKEN);
+    put_uint(static_cast<unsigned>(path[i]) + 1);
+
+    if (i + 1 < path.size()) {
+      int w = weight(i);
+      put(" - (", 4);
+      if (w < 0) {
+        put('-');
+        put_uint(static_cast<unsigned>(-static_cast<long long>(w)));
+      } else {
+        put_uint(static_cast<unsigned>(w));
+      }
+      put(") - ", 4);
+    }
+  }
+  reserve(1);
+  put('\n');
+}
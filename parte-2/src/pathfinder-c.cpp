@@ -0,0 +1,277 @@
+#include "pathfinder.h"
+#include "algorithm.hpp"
+#include "graph_components.hpp"
+#include "graph_parser.hpp"
+#include "logger.hpp"
+#include "numa_topology.hpp"
+#include "route_cache.hpp"
+#include "spatial_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+struct pf_graph {
+  Graph graph;
+  std::unique_ptr<RouteCache> cache; // null when disabled
+
+  // One read-only copy per NUMA node (empty until pf_numa_enable)
+  std::vector<Numa::Node> numa_nodes;
+  std::vector<std::unique_ptr<Graph>> replicas;
+
+  // Nearest-node index, built by the first snapping call
+  std::once_flag index_once;
+  std::unique_ptr<SpatialIndex> index;
+};
+
+struct pf_workspace {
+  explicit pf_workspace(pf_graph &h) : handle(h), solver(h.graph, 0, 0) {}
+
+  pf_graph &handle;
+  Algorithm solver;
+};
+
+static bool valid_node(const Graph &g, int u) { return u >= 0 && u < g.n; }
+
+static const SpatialIndex &spatial_index(pf_graph &h) {
+  std::call_once(h.index_once,
+                 [&] { h.index = std::make_unique<SpatialIndex>(h.graph); });
+  return *h.index;
+}
+
+// Degrees -> microdegrees (same rounding as the CLI)
+static Coord to_coord(double lat, double lon) {
+  return {static_cast<int>(std::lround(lon * 1000000.0)),
+          static_cast<int>(std::lround(lat * 1000000.0))};
+}
+
+// One query through the cache (if enabled). Fills path and returns the cost,
+// -1 if unreachable. `solver` may search any replica of h.graph.
+static long long cached_query(pf_graph &h, Algorithm &solver, int start,
+                              int goal, std::vector<int> &path) {
+  long long cost;
+  if (h.cache && h.cache->lookup(start, goal, h.graph.version, path, cost))
+    return cost;
+
+  solver.set_query(start, goal);
+  AlgorithmResult result = solver.run();
+  path = std::move(result.path);
+  if (path.empty())
+    return -1;
+
+  if (h.cache)
+    h.cache->insert(h.graph, path);
+  return static_cast<long long>(result.cost);
+}
+
+pf_graph *pf_graph_load(const char *dataset_name) {
+  if (dataset_name == nullptr)
+    return nullptr;
+
+  auto handle = std::unique_ptr<pf_graph>(new (std::nothrow) pf_graph());
+  if (!handle)
+    return nullptr;
+
+  // The host process owns stdout: no progress messages from the library
+  Logger::quiet() = true;
+
+  GraphParser parser(dataset_name);
+  handle->graph = parser.parse();
+
+  const Graph &g = handle->graph;
+  if (g.n == 0 || static_cast<int>(g.row_ptr.size()) != g.n + 1 ||
+      static_cast<int>(g.weights.size()) != g.m)
+    return nullptr;
+
+  GraphComponents::load_or_compute(handle->graph,
+                                   std::string(dataset_name) + ".scc");
+  return handle.release();
+}
+
+void pf_graph_free(pf_graph *graph) { delete graph; }
+
+int pf_graph_nodes(const pf_graph *graph) {
+  return graph ? graph->graph.n : 0;
+}
+
+pf_workspace *pf_workspace_create(const pf_graph *graph) {
+  if (graph == nullptr)
+    return nullptr;
+  // Queries only read the graph (the cache is synchronised internally)
+  return new (std::nothrow) pf_workspace(const_cast<pf_graph &>(*graph));
+}
+
+void pf_workspace_free(pf_workspace *ws) { delete ws; }
+
+int pf_query(pf_workspace *ws, int start, int goal, int *path,
+             int path_capacity, long long *cost) {
+  if (ws == nullptr || !valid_node(ws->handle.graph, start) ||
+      !valid_node(ws->handle.graph, goal))
+    return -1;
+
+  std::vector<int> result;
+  long long c = cached_query(ws->handle, ws->solver, start, goal, result);
+
+  if (cost != nullptr)
+    *cost = c;
+
+  int length = static_cast<int>(result.size());
+  if (path != nullptr && path_capacity > 0)
+    std::copy_n(result.begin(), std::min(length, path_capacity), path);
+  return length;
+}
+
+int pf_batch_query(const pf_graph *graph, const int *starts, const int *goals,
+                   long long *costs, int count, int threads) {
+  if (graph == nullptr || starts == nullptr || goals == nullptr ||
+      costs == nullptr || count < 0)
+    return -1;
+
+  if (threads <= 0)
+    threads = static_cast<int>(
+        std::max(1u, std::thread::hardware_concurrency()));
+  threads = std::max(1, std::min(threads, count));
+
+  pf_graph &h = const_cast<pf_graph &>(*graph);
+
+  // Each worker owns its workspace and a contiguous slice of the batch.
+  // With NUMA replicas, worker t runs on node t % nodes and both its
+  // replica and its workspace (first touch) live in local memory. Only
+  // threads spawned here are pinned.
+  auto worker = [&](int t, int begin, int end) {
+    Graph *local = &h.graph;
+    if (!h.replicas.empty()) {
+      std::size_t node = t % h.replicas.size();
+      Numa::pin_current_thread(h.numa_nodes[node].cpus);
+      local = h.replicas[node].get();
+    }
+
+    Algorithm solver(*local, 0, 0);
+    std::vector<int> path;
+    for (int i = begin; i < end; i++) {
+      if (!valid_node(h.graph, starts[i]) || !valid_node(h.graph, goals[i])) {
+        costs[i] = -1;
+        continue;
+      }
+      costs[i] = cached_query(h, solver, starts[i], goals[i], path);
+    }
+  };
+
+  // The caller's thread runs the batch only when it does not need pinning:
+  // pinning it would change its affinity for good
+  if (threads == 1 && h.replicas.empty()) {
+    worker(0, 0, count);
+    return 0;
+  }
+
+  std::vector<std::thread> workers;
+  int chunk = (count + threads - 1) / threads;
+  for (int t = 0; t < threads; t++) {
+    int begin = t * chunk;
+    int end = std::min(count, begin + chunk);
+    if (begin < end)
+      workers.emplace_back(worker, t, begin, end);
+  }
+  for (auto &w : workers)
+    w.join();
+  return 0;
+}
+
+int pf_snap_batch(const pf_graph *graph, const double *lats,
+                  const double *lons, int *out, int count, int threads) {
+  if (graph == nullptr || lats == nullptr || lons == nullptr ||
+      out == nullptr || count < 0)
+    return -1;
+
+  std::vector<Coord> points(count);
+  for (int i = 0; i < count; i++)
+    points[i] = to_coord(lats[i], lons[i]);
+
+  const SpatialIndex &index = spatial_index(const_cast<pf_graph &>(*graph));
+  index.nearest_batch(points.data(), out, points.size(),
+                      threads > 0 ? static_cast<unsigned>(threads) : 0);
+  return 0;
+}
+
+int pf_nearest_k(const pf_graph *graph, double lat, double lon, int *out,
+                 int k) {
+  if (graph == nullptr || (out == nullptr && k > 0) || k < 0)
+    return -1;
+
+  const SpatialIndex &index = spatial_index(const_cast<pf_graph &>(*graph));
+  std::vector<int> nodes = index.k_nearest(to_coord(lat, lon), k);
+  std::copy(nodes.begin(), nodes.end(), out);
+  return static_cast<int>(nodes.size());
+}
+
+int pf_cache_enable(pf_graph *graph, unsigned long long max_bytes) {
+  if (graph == nullptr)
+    return -1;
+  graph->cache.reset(max_bytes ? new (std::nothrow) RouteCache(max_bytes)
+                               : nullptr);
+  return (max_bytes && !graph->cache) ? -1 : 0;
+}
+
+int pf_cache_stats_get(const pf_graph *graph, pf_cache_stats *out) {
+  if (graph == nullptr || out == nullptr)
+    return -1;
+  if (!graph->cache) {
+    *out = pf_cache_stats{};
+    return 0;
+  }
+  RouteCache::Stats s = graph->cache->stats();
+  *out = pf_cache_stats{s.hits,    s.subpath_hits, s.misses,
+                        s.entries, s.bytes,        s.capacity};
+  return 0;
+}
+
+int pf_graph_set_weight(pf_graph *graph, int u, int v, int weight) {
+  if (graph == nullptr || !valid_node(graph->graph, u) ||
+      !valid_node(graph->graph, v))
+    return -1;
+
+  // A weight below the heuristic's estimate breaks the optimality of A*,
+  // and the cache would then serve subpaths of non-optimal routes
+  if (weight < 0 || weight < Algorithm::min_arc_weight(graph->graph, u, v))
+    return -1;
+
+  // Same change on the graph and on every replica
+  auto update = [&](Graph &g) {
+    int updated = 0;
+    for (int e = g.row_ptr[u]; e < g.row_ptr[u + 1]; e++) {
+      if (g.col_idx[e] == v) {
+        g.weights[e] = weight;
+        updated++;
+      }
+    }
+    if (updated)
+      g.version++;
+    return updated;
+  };
+
+  int updated = update(graph->graph);
+  for (auto &replica : graph->replicas)
+    update(*replica);
+  if (updated && graph->cache)
+    graph->cache->clear();
+  return updated;
+}
+
+int pf_numa_enable(pf_graph *graph) {
+  if (graph == nullptr)
+    return -1;
+
+  graph->numa_nodes = Numa::detect();
+  graph->replicas.clear();
+  // One node: a replica would only double the memory of the graph
+  if (graph->numa_nodes.size() <= 1) {
+    graph->numa_nodes.clear();
+    return 1;
+  }
+  for (const auto &node : graph->numa_nodes)
+    graph->replicas.push_back(Numa::replicate(graph->graph, node));
+  return static_cast<int>(graph->replicas.size());
+}
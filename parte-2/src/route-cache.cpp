@@ -0,0 +1,255 @@
+#include "route_cache.hpp"
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+// Sketch is halved after this many requests so old traffic fades out
+const std::uint64_t SKETCH_SAMPLE_FACTOR = 10;
+
+// Estimated allocation overhead per entry: exact_ node and bucket, the
+// three vector blocks of Entry and its slot
+const std::size_t ENTRY_OVERHEAD = 112;
+
+static inline std::uint64_t mix(std::uint64_t x) {
+  // splitmix64 finalizer
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+RouteCache::RouteCache(std::size_t max_bytes)
+    : max_bytes_(max_bytes),
+      sketch_(new std::atomic<std::uint8_t>[SKETCH_ROWS * SKETCH_WIDTH]) {
+  for (std::size_t i = 0; i < SKETCH_ROWS * SKETCH_WIDTH; i++)
+    sketch_[i].store(0, std::memory_order_relaxed);
+}
+
+void RouteCache::record(std::uint64_t k) {
+  for (int r = 0; r < SKETCH_ROWS; r++) {
+    std::size_t i = r * SKETCH_WIDTH + mix(k + r * 0x9e3779b97f4a7c15ULL) %
+                                           SKETCH_WIDTH;
+    if (sketch_[i].load(std::memory_order_relaxed) < 255)
+      sketch_[i].fetch_add(1, std::memory_order_relaxed);
+  }
+  sketch_additions_.fetch_add(1, std::memory_order_relaxed);
+}
+
+int RouteCache::frequency(std::uint64_t k) const {
+  int f = 255;
+  for (int r = 0; r < SKETCH_ROWS; r++) {
+    std::size_t i = r * SKETCH_WIDTH + mix(k + r * 0x9e3779b97f4a7c15ULL) %
+                                           SKETCH_WIDTH;
+    f = std::min<int>(f, sketch_[i].load(std::memory_order_relaxed));
+  }
+  return f;
+}
+
+bool RouteCache::lookup(int start, int goal, std::uint64_t version,
+                        std::vector<int> &path, long long &cost) {
+  std::uint64_t k = key(start, goal);
+  record(k);
+
+  std::shared_lock lock(mutex_);
+  if (version == version_) {
+    // 1. Exact hit
+    auto it = exact_.find(k);
+    if (it != exact_.end()) {
+      Entry &e = *slots_[it->second];
+      e.referenced.store(true, std::memory_order_relaxed);
+      path = e.nodes;
+      cost = e.prefix.back();
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    // 2. Subpath hit: start before goal on the same cached route
+    bool indexed = static_cast<std::size_t>(start) < head_.size() &&
+                   static_cast<std::size_t>(goal) < head_.size();
+    int first = indexed ? head_[start] : -1;
+    for (int i = first; i != -1; i = occurrence(i).next) {
+      const Occurrence &os = occurrence(i);
+      for (int j = head_[goal]; j != -1; j = occurrence(j).next) {
+        const Occurrence &ot = occurrence(j);
+        if (os.slot != ot.slot || ot.pos < os.pos)
+          continue;
+        Entry &e = *slots_[os.slot];
+        e.referenced.store(true, std::memory_order_relaxed);
+        path.assign(e.nodes.begin() + os.pos, e.nodes.begin() + ot.pos + 1);
+        cost = e.prefix[ot.pos] - e.prefix[os.pos];
+        subpath_hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+  }
+
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void RouteCache::insert(const Graph &g, const std::vector<int> &path) {
+  if (path.empty())
+    return;
+
+  // Build the entry outside the lock: prefix costs use the cheapest arc
+  // between consecutive nodes, the one an optimal search relaxes
+  auto entry = std::make_unique<Entry>();
+  entry->start = path.front();
+  entry->goal = path.back();
+  entry->nodes = path;
+  entry->prefix.resize(path.size());
+  entry->prefix[0] = 0;
+  for (std::size_t i = 0; i + 1 < path.size(); i++) {
+    int u = path[i];
+    int w = std::numeric_limits<int>::max();
+    for (int e = g.row_ptr[u]; e < g.row_ptr[u + 1]; e++)
+      if (g.col_idx[e] == path[i + 1])
+        w = std::min(w, g.weights[e]);
+    entry->prefix[i + 1] = entry->prefix[i] + w;
+  }
+  entry->bytes = sizeof(Entry) + ENTRY_OVERHEAD +
+                 path.size() * (2 * sizeof(int) + sizeof(long long) +
+                                sizeof(Occurrence));
+  if (entry->bytes > max_bytes_)
+    return;
+
+  std::uint64_t k = key(entry->start, entry->goal);
+
+  std::unique_lock lock(mutex_);
+
+  // New weights: every cached route may be stale
+  if (g.version != version_) {
+    clear_locked();
+    version_ = g.version;
+  }
+  if (exact_.count(k))
+    return;
+
+  // Occurrence index: one head per node of g, charged to the budget
+  if (head_.size() < static_cast<std::size_t>(g.n)) {
+    std::size_t index_bytes = static_cast<std::size_t>(g.n) * sizeof(int);
+    if (index_bytes + entry->bytes > max_bytes_)
+      return;
+    while (!slots_.empty() &&
+           bytes_ - head_.size() * sizeof(int) + index_bytes > max_bytes_)
+      evict(pick_victim());
+    bytes_ += index_bytes - head_.size() * sizeof(int);
+    head_.resize(g.n, -1);
+  }
+
+  // Sketch aging
+  if (sketch_additions_.load(std::memory_order_relaxed) >=
+      SKETCH_SAMPLE_FACTOR * SKETCH_WIDTH) {
+    for (std::size_t i = 0; i < SKETCH_ROWS * SKETCH_WIDTH; i++)
+      sketch_[i].store(sketch_[i].load(std::memory_order_relaxed) / 2,
+                       std::memory_order_relaxed);
+    sketch_additions_.store(0, std::memory_order_relaxed);
+  }
+
+  // Make room, unless the new route is colder than the victim (TinyLFU)
+  while (bytes_ + entry->bytes > max_bytes_) {
+    if (exact_.empty())
+      return;
+    int victim = pick_victim();
+    const Entry &v = *slots_[victim];
+    if (frequency(k) < frequency(key(v.start, v.goal)))
+      return;
+    evict(victim);
+  }
+
+  int slot;
+  if (!free_slots_.empty()) {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+  } else {
+    slot = static_cast<int>(slots_.size());
+    slots_.emplace_back();
+  }
+
+  entry->occurrences.resize(path.size());
+  for (std::size_t i = 0; i < path.size(); i++)
+    entry->occurrences[i] = link(path[i], slot, static_cast<int>(i));
+  exact_[k] = slot;
+  bytes_ += entry->bytes;
+  slots_[slot] = std::move(entry);
+}
+
+int RouteCache::pick_victim() {
+  // CLOCK: skip (and clear) recently referenced entries. Ends within two
+  // sweeps because the first one clears every reference bit.
+  while (true) {
+    if (hand_ >= slots_.size())
+      hand_ = 0;
+    const auto &e = slots_[hand_];
+    std::size_t current = hand_++;
+    if (e && !e->referenced.exchange(false, std::memory_order_relaxed))
+      return static_cast<int>(current);
+  }
+}
+
+int RouteCache::link(int node, int slot, int pos) {
+  int index;
+  if (free_occurrence_ != -1) {
+    index = free_occurrence_;
+    free_occurrence_ = occurrence(index).next;
+  } else {
+    index = pool_size_++;
+    if ((index >> POOL_BLOCK_BITS) == static_cast<int>(pool_.size()))
+      pool_.emplace_back(new Occurrence[1 << POOL_BLOCK_BITS]);
+  }
+  occurrence(index) = {slot, pos, -1, head_[node]};
+  if (head_[node] != -1)
+    occurrence(head_[node]).prev = index;
+  head_[node] = index;
+  return index;
+}
+
+void RouteCache::unlink(int node, int index) {
+  Occurrence &o = occurrence(index);
+  if (o.prev != -1)
+    occurrence(o.prev).next = o.next;
+  else
+    head_[node] = o.next;
+  if (o.next != -1)
+    occurrence(o.next).prev = o.prev;
+  o.next = free_occurrence_;
+  free_occurrence_ = index;
+}
+
+void RouteCache::evict(int slot) {
+  Entry &e = *slots_[slot];
+  for (std::size_t i = 0; i < e.nodes.size(); i++)
+    unlink(e.nodes[i], e.occurrences[i]);
+  exact_.erase(key(e.start, e.goal));
+  bytes_ -= e.bytes;
+  slots_[slot].reset();
+  free_slots_.push_back(slot);
+}
+
+void RouteCache::clear_locked() {
+  slots_.clear();
+  free_slots_.clear();
+  exact_.clear();
+  pool_size_ = 0; // blocks are kept for reuse
+  free_occurrence_ = -1;
+  std::fill(head_.begin(), head_.end(), -1);
+  bytes_ = head_.size() * sizeof(int);
+  hand_ = 0;
+}
+
+void RouteCache::clear() {
+  std::unique_lock lock(mutex_);
+  clear_locked();
+}
+
+RouteCache::Stats RouteCache::stats() const {
+  std::shared_lock lock(mutex_);
+  return Stats{hits_.load(std::memory_order_relaxed),
+               subpath_hits_.load(std::memory_order_relaxed),
+               misses_.load(std::memory_order_relaxed),
+               exact_.size(),
+               bytes_,
+               max_bytes_};
+}
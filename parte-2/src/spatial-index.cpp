@@ -0,0 +1,196 @@
+#include "spatial_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <thread>
+#include <utility>
+
+// Average number of nodes per cell: small enough to scan, large enough to
+// keep the grid compact
+const double NODES_PER_CELL = 4.0;
+
+// Cosine of a latitude given in microdegrees
+static double cos_lat(int lat) {
+  return std::cos((lat / 1000000.0) * (M_PI / 180.0));
+}
+
+// Squared distance in projected microdegrees
+static inline double dist_sq(Coord q, Coord p, double cos_q) {
+  double dlon = (static_cast<double>(p.lon) - q.lon) * cos_q;
+  double dlat = static_cast<double>(p.lat) - q.lat;
+  return dlon * dlon + dlat * dlat;
+}
+
+SpatialIndex::SpatialIndex(const Graph &g)
+    : min_lon_(0), min_lat_(0), cell_size_(1), nx_(1), ny_(1) {
+  if (g.n == 0) {
+    cell_ptr_.assign(2, 0);
+    return;
+  }
+
+  // 1. Bounding box
+  int max_lon = g.coords[0].lon;
+  int max_lat = g.coords[0].lat;
+  min_lon_ = max_lon;
+  min_lat_ = max_lat;
+  for (const Coord &c : g.coords) {
+    min_lon_ = std::min(min_lon_, c.lon);
+    min_lat_ = std::min(min_lat_, c.lat);
+    max_lon = std::max(max_lon, c.lon);
+    max_lat = std::max(max_lat, c.lat);
+  }
+
+  // 2. Square cells sized for NODES_PER_CELL nodes on average
+  double width = static_cast<double>(max_lon) - min_lon_ + 1;
+  double height = static_cast<double>(max_lat) - min_lat_ + 1;
+  double side = std::sqrt(width * height * NODES_PER_CELL / g.n);
+  cell_size_ = std::max(1, static_cast<int>(std::ceil(side)));
+  nx_ = static_cast<int>(width / cell_size_) + 1;
+  ny_ = static_cast<int>(height / cell_size_) + 1;
+
+  // 3. Counting sort of the nodes by cell
+  std::vector<int> cell(g.n);
+  cell_ptr_.assign(static_cast<std::size_t>(nx_) * ny_ + 1, 0);
+  for (int u = 0; u < g.n; u++) {
+    cell[u] = cell_y(g.coords[u].lat) * nx_ + cell_x(g.coords[u].lon);
+    cell_ptr_[cell[u] + 1]++;
+  }
+  for (std::size_t c = 1; c < cell_ptr_.size(); c++)
+    cell_ptr_[c] += cell_ptr_[c - 1];
+
+  std::vector<int> temp_ptr(cell_ptr_.begin(), cell_ptr_.end() - 1);
+  ids_.resize(g.n);
+  points_.resize(g.n);
+  for (int u = 0; u < g.n; u++) {
+    int pos = temp_ptr[cell[u]]++;
+    ids_[pos] = u;
+    points_[pos] = g.coords[u];
+  }
+}
+
+int SpatialIndex::cell_x(int lon) const {
+  long long x = (static_cast<long long>(lon) - min_lon_) / cell_size_;
+  return static_cast<int>(std::clamp<long long>(x, 0, nx_ - 1));
+}
+
+int SpatialIndex::cell_y(int lat) const {
+  long long y = (static_cast<long long>(lat) - min_lat_) / cell_size_;
+  return static_cast<int>(std::clamp<long long>(y, 0, ny_ - 1));
+}
+
+template <typename F>
+void SpatialIndex::for_ring(int cx, int cy, int r, F &&visit) const {
+  auto cell = [&](int x, int y) {
+    if (x < 0 || y < 0 || x >= nx_ || y >= ny_)
+      return;
+    int c = y * nx_ + x;
+    for (int i = cell_ptr_[c]; i < cell_ptr_[c + 1]; i++)
+      visit(i);
+  };
+
+  if (r == 0) {
+    cell(cx, cy);
+    return;
+  }
+  for (int x = cx - r; x <= cx + r; x++) {
+    cell(x, cy - r);
+    cell(x, cy + r);
+  }
+  for (int y = cy - r + 1; y <= cy + r - 1; y++) {
+    cell(cx - r, y);
+    cell(cx + r, y);
+  }
+}
+
+int SpatialIndex::nearest(Coord q) const {
+  if (ids_.empty())
+    return -1;
+
+  double cos_q = cos_lat(q.lat);
+  int cx = cell_x(q.lon);
+  int cy = cell_y(q.lat);
+  int max_r = std::max(nx_, ny_);
+
+  int best = -1;
+  double best_d = 0;
+  for (int r = 0; r <= max_r; r++) {
+    for_ring(cx, cy, r, [&](int i) {
+      double d = dist_sq(q, points_[i], cos_q);
+      if (best == -1 || d < best_d) {
+        best_d = d;
+        best = i;
+      }
+    });
+
+    // Any node beyond ring r is at least r cells away
+    double bound = r * static_cast<double>(cell_size_) * std::min(1.0, cos_q);
+    if (best != -1 && best_d <= bound * bound)
+      break;
+  }
+  return ids_[best];
+}
+
+std::vector<int> SpatialIndex::k_nearest(Coord q, int k) const {
+  std::vector<int> result;
+  if (ids_.empty() || k <= 0)
+    return result;
+
+  double cos_q = cos_lat(q.lat);
+  int cx = cell_x(q.lon);
+  int cy = cell_y(q.lat);
+  int max_r = std::max(nx_, ny_);
+  std::size_t limit = std::min<std::size_t>(k, ids_.size());
+
+  // Max-heap with the k best candidates seen so far
+  std::priority_queue<std::pair<double, int>> best;
+  for (int r = 0; r <= max_r; r++) {
+    for_ring(cx, cy, r, [&](int i) {
+      double d = dist_sq(q, points_[i], cos_q);
+      if (best.size() < limit) {
+        best.push({d, i});
+      } else if (d < best.top().first) {
+        best.pop();
+        best.push({d, i});
+      }
+    });
+
+    double bound = r * static_cast<double>(cell_size_) * std::min(1.0, cos_q);
+    if (best.size() == limit && best.top().first <= bound * bound)
+      break;
+  }
+
+  result.resize(best.size());
+  for (std::size_t i = result.size(); i-- > 0;) {
+    result[i] = ids_[best.top().second];
+    best.pop();
+  }
+  return result;
+}
+
+void SpatialIndex::nearest_batch(const Coord *queries, int *out,
+                                 std::size_t count, unsigned threads) const {
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  // Not worth spawning threads for a handful of points
+  threads = static_cast<unsigned>(
+      std::min<std::size_t>(threads, (count + 255) / 256));
+
+  if (threads <= 1) {
+    for (std::size_t i = 0; i < count; i++)
+      out[i] = nearest(queries[i]);
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  std::size_t chunk = (count + threads - 1) / threads;
+  for (unsigned t = 0; t < threads; t++) {
+    std::size_t begin = t * chunk;
+    std::size_t end = std::min(count, begin + chunk);
+    workers.emplace_back([this, queries, out, begin, end] {
+      for (std::size_t i = begin; i < end; i++)
+        out[i] = nearest(queries[i]);
+    });
+  }
+  for (auto &w : workers)
+    w.join();
+}